@@ -0,0 +1,1890 @@
+#include <print>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <bit>
+#include <list>
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include "src/game/GameMap.hpp"
+#include "src/game/GameState.hpp"
+#include "src/cards/CardLoader.hpp"
+#include "src/targeting/TargetSelectorFactory.hpp"
+#include "src/effects/ComposedEffectFactory.hpp"
+#include "src/utils/StrColors.hpp"
+
+using namespace std;
+
+// Contadores globales de reservas y liberaciones en el heap (para comprobar
+// caminos sin memoria dinámica y desmontajes sin fugas)
+static size_t heapAllocations = 0;
+static size_t heapReleases = 0;
+
+void* operator new(size_t size) {
+    ++heapAllocations;
+    if (void* block = malloc(size ? size : 1)) return block;
+    throw bad_alloc();
+}
+// noinline: si GCC ve el free junto al new reemplazado avisa (falso positivo) con -Wmismatched-new-delete
+[[gnu::noinline]] void operator delete(void* block) noexcept {
+    if (block) ++heapReleases;
+    free(block);
+}
+[[gnu::noinline]] void operator delete(void* block, size_t) noexcept {
+    if (block) ++heapReleases;
+    free(block);
+}
+
+// ===========================
+// MICROBENCHMARKS DEL MOTOR
+// ===========================
+
+namespace {
+
+// Evita que el compilador elimine el trabajo medido
+volatile uintptr_t benchSink = 0;
+
+template <typename F>
+double measureNanosPerOp(size_t iterations, F&& body) {
+    auto start = chrono::steady_clock::now();
+    body(iterations);
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / static_cast<double>(iterations);
+}
+
+void printBenchResult(const string& name, double nanosPerOp) {
+    using namespace StrColors;
+    println("  {}{}{}: {} ns/op", CYAN, name, RESET, nanosPerOp);
+}
+
+// Réplica del camino anterior de GameMap::getNeighbor: búsqueda lineal de la
+// celda para obtener (x, y), inversión de dirección y aritmética de offsets
+MapCell* legacyGetNeighbor(GameMap& map, GameMap::Adjacency direction, const MapCell* cell, PlayerId playerId) {
+    if (!cell) return nullptr;
+    if (playerId == 1) direction = GameMap::invertDirection(direction);
+
+    uint8_t cellX = 255, cellY = 255;
+    for (uint8_t y = 0; y < map.getHeight() && cellX == 255; ++y) {
+        for (uint8_t x = 0; x < map.getWidth(); ++x) {
+            if (map.at(x, y) == cell) { cellX = x; cellY = y; break; }
+        }
+    }
+    if (cellX == 255) return nullptr;
+
+    static constexpr array<pair<int, int>, 6> offsets = {{
+        {0, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}
+    }};
+    auto [dx, dy] = offsets[static_cast<uint8_t>(direction)];
+    int nx = cellX + dx, ny = cellY + dy;
+    if (nx < 0 || ny < 0) return nullptr;
+    return map.at(static_cast<uint8_t>(nx), static_cast<uint8_t>(ny));
+}
+
+bool benchNeighborLookup() {
+    using namespace StrColors;
+    println("{}=== Vecindad: getNeighbor legacy vs tabla precalculada ==={}", BOLD, RESET);
+
+    // Verificar primero que ambos caminos coinciden en todos los tableros soportados
+    for (const MapLayout* layout : SUPPORTED_MAP_LAYOUTS) {
+        GameMap sized(layout->width, layout->height);
+        for (PlayerId player = 0; player < 2; ++player) {
+            for (CellIndex cell = 0; cell < sized.getCellCount(); ++cell) {
+                for (uint8_t d = 0; d < 6; ++d) {
+                    auto direction = static_cast<GameMap::Adjacency>(d);
+                    MapCell* expected = legacyGetNeighbor(sized, direction, sized.at(cell), player);
+                    if (sized.at(sized.getNeighbor(direction, cell, player)) != expected) {
+                        println("{}✗ Tabla de vecinos {}x{} difiere en celda {} dirección {} jugador {}{}",
+                                RED, layout->width, layout->height, cell, d, player, RESET);
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    // El selector de adyacentes usa la misma vecindad hexagonal: con el
+    // tablero lleno, cada unidad selecciona exactamente sus vecinas
+    GameMap filled;
+    vector<shared_ptr<Unit>> units;
+    GameMap::forEachCell(filled.getWalkableMask(), [&](CellIndex index) {
+        auto unit = make_shared<Unit>(index, "U", 1, "", index & 1, 1, 5, 1, 1);
+        filled.placeCard(index, unit);
+        const auto [x, y] = filled.toCoordinates(index);
+        unit->setPosition(x, y);
+        units.push_back(unit);
+    });
+    for (const auto& unit : units) {
+        const auto [x, y] = unit->getCoordinates();
+        const CellIndex cell = filled.toIndex(x, y);
+        const uint64_t neighbors = filled.getNeighborMask(cell, unit->getOwner()) & filled.getOccupiedMask();
+        AdjacentTargetSelector all(unit, unit->getOwner());
+        AdjacentTargetSelector enemies(unit, unit->getOwner(), AdjacentTargetSelector::FilterType::ENEMIES_ONLY);
+        uint64_t selectedAll = 0, selectedEnemies = 0;
+        for (MapCell* target : all.selectTargets(filled, nullptr)) selectedAll |= uint64_t{1} << filled.indexOf(target);
+        for (MapCell* target : enemies.selectTargets(filled, nullptr)) selectedEnemies |= uint64_t{1} << filled.indexOf(target);
+        if (selectedAll != neighbors || selectedEnemies != (neighbors & filled.getEnemyMask(unit->getOwner()))) {
+            println("{}✗ El selector de adyacentes difiere de la tabla de vecinos en la celda {}{}", RED, static_cast<int>(cell), RESET);
+            return false;
+        }
+    }
+
+    GameMap map;
+    const uint8_t cellCount = map.getCellCount();
+
+    // Consultas pregeneradas para que el bucle mida solo la búsqueda de vecinos
+    struct Query { CellIndex cell; GameMap::Adjacency direction; PlayerId player; };
+    array<Query, 4096> queries{};
+    for (size_t i = 0; i < queries.size(); ++i) {
+        queries[i] = {static_cast<CellIndex>((i * 7) % cellCount), 
+                      static_cast<GameMap::Adjacency>((i * 5) % 6), 
+                      static_cast<PlayerId>((i / 3) & 1)};
+    }
+
+    constexpr size_t ITERATIONS = 5'000'000;
+
+    double legacy = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uintptr_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const Query& q = queries[i & (queries.size() - 1)];
+            acc += reinterpret_cast<uintptr_t>(legacyGetNeighbor(map, q.direction, map.at(q.cell), q.player));
+        }
+        benchSink = acc;
+    });
+
+    double table = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uintptr_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const Query& q = queries[i & (queries.size() - 1)];
+            acc += reinterpret_cast<uintptr_t>(map.at(map.getNeighbor(q.direction, q.cell, q.player)));
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("legacy getNeighbor (búsqueda lineal)", legacy);
+    printBenchResult("tabla constexpr", table);
+    println("  Speedup: {}x", legacy / table);
+    return true;
+}
+
+// Réplica del camino anterior: recorrer las celdas comprobando suelo, carta y adyacencia
+uint64_t legacyPlacementCandidates(const GameMap& map, PlayerId playerId, CellIndex legendCell) {
+    uint64_t result = 0;
+    for (CellIndex index = 0; index < map.getCellCount(); ++index) {
+        const MapCell* cell = map.at(index);
+        if (cell->floor == MapCell::FloorType::NONE || cell->hasCard()) continue;
+        for (uint8_t d = 0; d < 6; ++d) {
+            if (map.getNeighbor(static_cast<GameMap::Adjacency>(d), legendCell, playerId) == index) {
+                result |= uint64_t{1} << index;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+bool benchOccupancyQueries() {
+    using namespace StrColors;
+    println("{}=== Ocupación: recorrido de celdas vs bitboards ==={}", BOLD, RESET);
+
+    // Tablero con ambas leyendas y algunas unidades alrededor
+    GameMap map;
+    auto [spawn0X, spawn0Y] = map.getSpawnPosition(0);
+    auto [spawn1X, spawn1Y] = map.getSpawnPosition(1);
+    map.placeCard(map.toIndex(spawn0X, spawn0Y), make_shared<Legend>(1, "L0", 0, "", 0, 2, 20, 1, 1));
+    map.placeCard(map.toIndex(spawn1X, spawn1Y), make_shared<Legend>(2, "L1", 0, "", 1, 2, 20, 1, 1));
+    map.placeCard(map.toIndex(2, 1), make_shared<Unit>(3, "U0", 1, "", 0, 1, 3, 1, 1));
+    map.placeCard(map.toIndex(2, 5), make_shared<Unit>(4, "U1", 1, "", 1, 1, 3, 1, 1));
+    map.placeCard(map.toIndex(1, 4), make_shared<Unit>(5, "U2", 1, "", 1, 1, 3, 1, 1));
+
+    for (PlayerId player = 0; player < 2; ++player) {
+        uint64_t expected = legacyPlacementCandidates(map, player, map.getLegendCell(player));
+        if (map.getPlacementMask(player) != expected) {
+            println("{}✗ Máscara de invocación difiere para jugador {}{}", RED, player, RESET);
+            return false;
+        }
+    }
+
+    constexpr size_t ITERATIONS = 2'000'000;
+
+    double legacy = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            PlayerId player = static_cast<PlayerId>(i & 1);
+            acc += legacyPlacementCandidates(map, player, map.getLegendCell(player));
+        }
+        benchSink = acc;
+    });
+
+    double bitboard = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += map.getPlacementMask(static_cast<PlayerId>(i & 1));
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("candidatas de invocación (recorrido)", legacy);
+    printBenchResult("candidatas de invocación (bitboards)", bitboard);
+    println("  Speedup: {}x", legacy / bitboard);
+    return true;
+}
+
+// Distancias calculadas en tiempo de ejecución con BFS sobre getNeighbor
+bool verifyDistanceTable(const GameMap& map) {
+    for (CellIndex source = 0; source < map.getCellCount(); ++source) {
+        array<uint8_t, GameMap::MAX_CELLS> distance{};
+        distance.fill(MapGeometryDetail::UNREACHABLE);
+        array<CellIndex, GameMap::MAX_CELLS> queue{};
+        size_t head = 0, tail = 0;
+        distance[source] = 0;
+        queue[tail++] = source;
+        while (head < tail) {
+            CellIndex cell = queue[head++];
+            for (uint8_t d = 0; d < 6; ++d) {
+                CellIndex next = map.getNeighbor(static_cast<GameMap::Adjacency>(d), cell);
+                if (next == NO_CELL || distance[next] != MapGeometryDetail::UNREACHABLE) continue;
+                distance[next] = distance[cell] + 1;
+                queue[tail++] = next;
+            }
+        }
+        for (CellIndex target = 0; target < map.getCellCount(); ++target) {
+            if (map.getDistance(source, target) != distance[target]) return false;
+        }
+    }
+    return true;
+}
+
+bool benchAttackTargets() {
+    using namespace StrColors;
+    println("{}=== Ataque: recorrido con distancias vs máscaras de rango ==={}", BOLD, RESET);
+
+    for (const MapLayout* layout : SUPPORTED_MAP_LAYOUTS) {
+        if (!verifyDistanceTable(GameMap(layout->width, layout->height))) {
+            println("{}✗ Tabla de distancias {}x{} difiere del BFS{}", RED, layout->width, layout->height, RESET);
+            return false;
+        }
+    }
+
+    // Unidades de ambos jugadores repartidas por el tablero
+    GameMap map;
+    for (CellIndex index = 0; index < map.getCellCount(); index += 3) {
+        map.placeCard(index, make_shared<Unit>(index, "U", 1, "", index & 1, 1, 3, 1, 1));
+    }
+
+    constexpr size_t ITERATIONS = 2'000'000;
+    const uint8_t cellCount = map.getCellCount();
+
+    double scan = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            CellIndex from = static_cast<CellIndex>(i % cellCount);
+            PlayerId player = static_cast<PlayerId>(i & 1);
+            uint8_t range = static_cast<uint8_t>(1 + (i & 3));
+            for (CellIndex target = 0; target < cellCount; ++target) {
+                const MapCell* cell = map.at(target);
+                if (cell->hasCard() && map.getCard(cell)->getOwner() != player &&
+                    map.getDistance(from, target) <= range) {
+                    acc += target;
+                }
+            }
+        }
+        benchSink = acc;
+    });
+
+    double masks = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            CellIndex from = static_cast<CellIndex>(i % cellCount);
+            GameMap::forEachCell(map.getAttackMask(from, static_cast<uint8_t>(1 + (i & 3)), static_cast<PlayerId>(i & 1)),
+                                 [&](CellIndex target) { acc += target; });
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("objetivos en rango (recorrido + distancia)", scan);
+    printBenchResult("objetivos en rango (máscaras)", masks);
+    println("  Speedup: {}x", scan / masks);
+    return true;
+}
+
+// BFS escalar con cola acotada por velocidad (referencia para la versión sobre bitboards)
+uint64_t scalarReachable(const GameMap& map, CellIndex origin, uint8_t speed) {
+    array<uint8_t, GameMap::MAX_CELLS> distance{};
+    distance.fill(0xFF);
+    array<CellIndex, GameMap::MAX_CELLS> queue{};
+    size_t head = 0, tail = 0;
+    uint64_t reachable = 0;
+    distance[origin] = 0;
+    queue[tail++] = origin;
+    while (head < tail) {
+        CellIndex cell = queue[head++];
+        if (distance[cell] == speed) continue;
+        for (uint8_t d = 0; d < 6; ++d) {
+            CellIndex next = map.getNeighbor(static_cast<GameMap::Adjacency>(d), cell);
+            if (next == NO_CELL || distance[next] != 0xFF || !map.isEmpty(next)) continue;
+            distance[next] = distance[cell] + 1;
+            reachable |= uint64_t{1} << next;
+            queue[tail++] = next;
+        }
+    }
+    return reachable;
+}
+
+bool benchReachability() {
+    using namespace StrColors;
+    println("{}=== Movimiento: BFS escalar vs BFS sobre bitboards ==={}", BOLD, RESET);
+
+    GameMap map;
+    for (CellIndex index = 1; index < map.getCellCount(); index += 4) {
+        map.placeCard(index, make_shared<Unit>(index, "U", 1, "", index & 1, 1, 3, 1, 1));
+    }
+
+    const uint8_t cellCount = map.getCellCount();
+    for (CellIndex origin = 0; origin < cellCount; ++origin) {
+        for (uint8_t speed = 0; speed <= 4; ++speed) {
+            if (map.getReachableMask(origin, speed) != scalarReachable(map, origin, speed)) {
+                println("{}✗ Alcance difiere en celda {} velocidad {}{}", RED, origin, speed, RESET);
+                return false;
+            }
+        }
+    }
+
+    constexpr size_t ITERATIONS = 2'000'000;
+
+    double scalar = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += scalarReachable(map, static_cast<CellIndex>(i % cellCount), static_cast<uint8_t>(1 + (i & 1)));
+        }
+        benchSink = acc;
+    });
+
+    double bitboard = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += map.getReachableMask(static_cast<CellIndex>(i % cellCount), static_cast<uint8_t>(1 + (i & 1)));
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("alcance (BFS escalar)", scalar);
+    printBenchResult("alcance (bitboards)", bitboard);
+    println("  Speedup: {}x", scalar / bitboard);
+    return true;
+}
+
+// Réplica del recorrido anterior: encadenar el getNeighbor legacy paso a paso hasta la primera carta
+CellIndex steppedFirstBlocker(GameMap& map, GameMap::Adjacency direction, CellIndex cell, PlayerId player) {
+    for (MapCell* next = legacyGetNeighbor(map, direction, map.at(cell), player); next;
+         next = legacyGetNeighbor(map, direction, next, player)) {
+        if (next->hasCard()) return map.indexOf(next);
+    }
+    return NO_CELL;
+}
+
+bool benchRays() {
+    using namespace StrColors;
+    println("{}=== Líneas: getNeighbor paso a paso vs rayos precalculados ==={}", BOLD, RESET);
+
+    // Los rayos deben coincidir con encadenar la tabla de vecinos en todos los tableros
+    for (const MapLayout* layout : SUPPORTED_MAP_LAYOUTS) {
+        GameMap sized(layout->width, layout->height);
+        for (PlayerId player = 0; player < 2; ++player) {
+            for (CellIndex cell = 0; cell < sized.getCellCount(); ++cell) {
+                for (uint8_t d = 0; d < 6; ++d) {
+                    auto direction = static_cast<GameMap::Adjacency>(d);
+                    CellIndex expected = sized.getNeighbor(direction, cell, player);
+                    for (CellIndex index : sized.getRay(direction, cell, player)) {
+                        if (index != expected) {
+                            println("{}✗ Rayo {}x{} difiere en celda {} dirección {}{}",
+                                    RED, layout->width, layout->height, cell, d, RESET);
+                            return false;
+                        }
+                        expected = sized.getNeighbor(direction, index, player);
+                    }
+                    if (expected != NO_CELL) {
+                        println("{}✗ Rayo {}x{} incompleto en celda {} dirección {}{}",
+                                RED, layout->width, layout->height, cell, d, RESET);
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    GameMap map;
+    for (CellIndex index = 2; index < map.getCellCount(); index += 5) {
+        map.placeCard(index, make_shared<Unit>(index, "U", 1, "", index & 1, 1, 3, 1, 1));
+    }
+
+    for (CellIndex cell = 0; cell < map.getCellCount(); ++cell) {
+        for (uint8_t d = 0; d < 6; ++d) {
+            auto direction = static_cast<GameMap::Adjacency>(d);
+            if (map.getFirstBlocker(direction, cell, 1) != steppedFirstBlocker(map, direction, cell, 1)) {
+                println("{}✗ Primera carta en línea difiere en celda {} dirección {}{}", RED, cell, d, RESET);
+                return false;
+            }
+        }
+    }
+
+    constexpr size_t ITERATIONS = 2'000'000;
+    const uint8_t cellCount = map.getCellCount();
+
+    double stepped = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += steppedFirstBlocker(map, static_cast<GameMap::Adjacency>(i % 6),
+                                       static_cast<CellIndex>(i % cellCount), static_cast<PlayerId>((i / 7) & 1));
+        }
+        benchSink = acc;
+    });
+
+    double rays = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += map.getFirstBlocker(static_cast<GameMap::Adjacency>(i % 6),
+                                       static_cast<CellIndex>(i % cellCount), static_cast<PlayerId>((i / 7) & 1));
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("primera carta en línea (legacy paso a paso)", stepped);
+    printBenchResult("primera carta en línea (rayos)", rays);
+    println("  Speedup: {}x", stepped / rays);
+    return true;
+}
+
+// Partida corta con acciones válidas, comprobando tras cada una que el hash
+// incremental coincide con el recalculado desde cero
+bool benchStateHash() {
+    using namespace StrColors;
+    println("{}=== Hash Zobrist: incremental vs recálculo completo ==={}", BOLD, RESET);
+
+    auto deckConfigs = CardLoader::loadDecksFromFile("decks.json");
+    if (deckConfigs.size() < 2) {
+        println("{}✗ No se pudieron cargar los mazos de decks.json{}", RED, RESET);
+        return false;
+    }
+    GameConfig config;
+    config.loadFromFile("game_config.conf");
+    GameState state(CardLoader::createCardsFromConfig(deckConfigs[0], 0),
+                    CardLoader::createCardsFromConfig(deckConfigs[1], 1), config);
+
+    auto checkHash = [&](const char* step) {
+        if (state.getStateHash() != state.computeStateHash()) {
+            println("{}✗ Hash incremental difiere del recalculado tras {}{}", RED, step, RESET);
+            return false;
+        }
+        return true;
+    };
+    if (!checkHash("iniciar la partida")) return false;
+
+    for (int action = 0; action < 30 && !state.isGameOver(); ++action) {
+        PlayerId player = state.getCurrentPlayer();
+        const GameMap& map = state.getMap();
+        const Player& current = state.getPlayer(player);
+
+        uint64_t placements = map.getPlacementMask(player) & map.getTerritoryMask(player);
+        if (!current.hand.empty() && placements && current.actionsRemaining > 0) {
+            auto [x, y] = map.toCoordinates(static_cast<CellIndex>(countr_zero(placements)));
+            state.playCard(player, current.hand.front(), x, y);
+            if (!checkHash("jugar una carta")) return false;
+            continue;
+        }
+
+        // Mover la primera unidad propia que pueda hacerlo
+        bool moved = false;
+        GameMap::forEachCell(map.getOccupancyMask(player), [&](CellIndex index) {
+            if (moved || current.actionsRemaining == 0) return;
+            CardPtr card = map.getCard(index);
+            uint64_t reachable = state.getReachableMask(card);
+            if (!reachable) return;
+            auto [x, y] = map.toCoordinates(static_cast<CellIndex>(countr_zero(reachable)));
+            moved = state.moveCard(player, card, x, y);
+        });
+        if (moved) {
+            if (!checkHash("mover una unidad")) return false;
+            continue;
+        }
+
+        state.endTurn(player);
+        if (!checkHash("terminar el turno")) return false;
+    }
+
+    // applyToCards escribe en las unidades sin pasar por los kernels: cada
+    // escritura actualiza su celda y el hash del tablero
+    GameMap board;
+    CardList cards;
+    GameMap::forEachCell(board.getEmptyMask(), [&](CellIndex index) {
+        auto unit = make_shared<Unit>(index, "U", 1, "", index & 1, 3, 5, 2, 2);
+        board.placeCard(index, unit);
+        cards.push_back(unit);
+    });
+    const CardPtr source = cards.front();
+    const EffectImplPtr writers[] = {
+        make_shared<AttackModifierEffectImpl>(source, 0, 2), make_shared<HealthModifierEffectImpl>(source, 0, -1),
+        make_shared<DamageEffectImpl>(source, 0, 1), make_shared<HealEffectImpl>(source, 0, 1),
+        make_shared<RangeModifierEffectImpl>(source, 0, 1), make_shared<SpeedModifierEffectImpl>(source, 0, 1),
+        make_shared<DestroyEffectImpl>(source, 0)
+    };
+    for (const EffectImplPtr& writer : writers) {
+        writer->applyToCards(board, nullptr, cards);
+        if (board.getBoardHash() != board.computeBoardHash()) {
+            println("{}✗ Hash del tablero desactualizado tras {}::applyToCards{}", RED, writer->getName(), RESET);
+            return false;
+        }
+    }
+
+    constexpr size_t ITERATIONS = 1'000'000;
+
+    double full = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) acc += state.computeStateHash();
+        benchSink = acc;
+    });
+
+    double incremental = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) acc += state.getStateHash();
+        benchSink = acc;
+    });
+
+    printBenchResult("hash (recálculo completo)", full);
+    printBenchResult("hash (incremental)", incremental);
+    println("  Speedup: {}x", full / incremental);
+    return true;
+}
+
+// Réplica del bucle anterior de AttackModifier/HealthModifier: un
+// dynamic_pointer_cast y una llamada a través de shared_ptr por objetivo
+void legacyModifyStats(const list<CardPtr>& targets, int attackChange, int healthChange) {
+    for (const auto& card : targets) {
+        if (auto unit = dynamic_pointer_cast<Unit>(card)) {
+            unit->setAttack(static_cast<uint8_t>(clamp(static_cast<int>(unit->getAttack()) + attackChange, 0, 255)));
+            if (healthChange > 0) unit->heal(healthChange);
+            else unit->takeDamage(-healthChange);
+        }
+    }
+}
+
+bool benchStatKernels() {
+    using namespace StrColors;
+    println("{}=== Estadísticas: objetos Unit vs columnas SoA ==={}", BOLD, RESET);
+
+    // Tablero lleno de unidades; las copias sueltas siguen el camino antiguo
+    GameMap map;
+    list<MapCell*> targetCells;
+    list<CardPtr> legacyTargets;
+    GameMap::forEachCell(map.getEmptyMask(), [&](CellIndex index) {
+        const uint8_t health = static_cast<uint8_t>(5 + index % 7);
+        map.placeCard(index, make_shared<Unit>(index, "U", 1, "", index & 1, 3, health, 1, 1));
+        legacyTargets.push_back(make_shared<Unit>(index, "U", 1, "", index & 1, 3, health, 1, 1));
+        targetCells.push_back(map.at(index));
+    });
+
+    constexpr array<pair<int, int>, 4> deltas = {{{2, -3}, {-1, 2}, {-4, -1}, {5, 6}}};
+    auto applyKernels = [&](int attackChange, int healthChange) {
+        const auto selection = map.selectUnits(targetCells);
+        map.getUnitStats().addAttack(selection, attackChange);
+        map.getUnitStats().addHealth(selection, healthChange);
+    };
+
+    for (const auto& [attackChange, healthChange] : deltas) {
+        applyKernels(attackChange, healthChange);
+        legacyModifyStats(legacyTargets, attackChange, healthChange);
+    }
+    auto legacy = legacyTargets.begin();
+    for (MapCell* cell : targetCells) {
+        auto unit = dynamic_pointer_cast<Unit>(map.getCard(cell));
+        auto expected = dynamic_pointer_cast<Unit>(*legacy++);
+        if (unit->getAttack() != expected->getAttack() || unit->getHealth() != expected->getHealth()) {
+            println("{}✗ Estadísticas difieren en celda {}{}", RED, map.indexOf(cell), RESET);
+            return false;
+        }
+    }
+
+    constexpr size_t ITERATIONS = 500'000;
+
+    double objects = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const auto& [attackChange, healthChange] = deltas[i & 3];
+            legacyModifyStats(legacyTargets, attackChange, healthChange);
+        }
+        benchSink = dynamic_pointer_cast<Unit>(legacyTargets.front())->getHealth();
+    });
+
+    double columns = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const auto& [attackChange, healthChange] = deltas[i & 3];
+            applyKernels(attackChange, healthChange);
+        }
+        benchSink = map.getUnitStats().health[0];
+    });
+
+    printBenchResult("buff+daño (objetos Unit)", objects);
+    printBenchResult("buff+daño (columnas SoA)", columns);
+    println("  Speedup: {}x", objects / columns);
+    return true;
+}
+
+// Réplica de la creación anterior: cada carta copia nombre y descripción
+CardPtr legacyCreateCard(const CardLoader::CardConfig& cardConfig, PlayerId owner) {
+    if (cardConfig.type == "spell") {
+        return make_shared<Spell>(cardConfig.id, cardConfig.name, cardConfig.cost, cardConfig.description, owner);
+    }
+    if (cardConfig.type == "legend") {
+        return make_shared<Legend>(cardConfig.id, cardConfig.name, cardConfig.cost, cardConfig.description, owner,
+                                   cardConfig.attack, cardConfig.health, cardConfig.speed, cardConfig.range);
+    }
+    return make_shared<Unit>(cardConfig.id, cardConfig.name, cardConfig.cost, cardConfig.description, owner,
+                             cardConfig.attack, cardConfig.health, cardConfig.speed, cardConfig.range);
+}
+
+bool benchCardPrototypes() {
+    using namespace StrColors;
+    println("{}=== Cartas: copia de textos vs prototipos compartidos ==={}", BOLD, RESET);
+
+    auto catalog = CardLoader::loadCatalog("decks.json");
+    if (catalog->empty() || CardLoader::loadCatalog("decks.json") != catalog) {
+        println("{}✗ El catálogo de decks.json no se comparte entre llamadas{}", RED, RESET);
+        return false;
+    }
+    const CardLoader::DeckConfig& deck = catalog->front();
+
+    // Dos partidas deben apuntar a los mismos datos inmutables
+    auto first = CardLoader::createCardsFromConfig(deck, 0);
+    auto second = CardLoader::createCardsFromConfig(deck, 1);
+    for (size_t i = 0; i < first.size(); ++i) {
+        if (&first[i]->getPrototype() != &second[i]->getPrototype() ||
+            first[i]->getName() != deck.cards[i].name) {
+            println("{}✗ La carta {} no comparte prototipo entre partidas{}", RED, i, RESET);
+            return false;
+        }
+    }
+
+    constexpr size_t ITERATIONS = 200'000;
+
+    double copies = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uintptr_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const auto& cardConfig = deck.cards[i % deck.cards.size()];
+            acc += legacyCreateCard(cardConfig, i & 1)->getName().size();
+        }
+        benchSink = acc;
+    });
+
+    double prototypes = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uintptr_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const auto& cardConfig = deck.cards[i % deck.cards.size()];
+            CardPtr card = cardConfig.prototype->kind & Card::LEGEND ? CardPtr(make_shared<Legend>(cardConfig.prototype, i & 1))
+                         : cardConfig.prototype->kind & Card::UNIT   ? CardPtr(make_shared<Unit>(cardConfig.prototype, i & 1))
+                                                                     : CardPtr(make_shared<Spell>(cardConfig.prototype, i & 1));
+            acc += card->getName().size();
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("crear carta (copia de textos)", copies);
+    printBenchResult("crear carta (prototipo)", prototypes);
+    println("  Speedup: {}x", copies / prototypes);
+    return true;
+}
+
+// Crear y destruir los mazos de una partida: cartas, efectos, triggers y
+// selectores. Sin arena, los ciclos carta -> efecto -> carta nunca se liberan
+bool benchGameArena() {
+    using namespace StrColors;
+    println("{}=== Mazos: make_shared vs arena por partida ==={}", BOLD, RESET);
+
+    auto catalog = CardLoader::loadCatalog("decks.json");
+    if (catalog->size() < 2) {
+        println("{}✗ No se pudieron cargar los mazos de decks.json{}", RED, RESET);
+        return false;
+    }
+
+    // Las cartas y sus efectos deben salir de la arena activa
+    {
+        GameArena arena;
+        size_t cards = 0;
+        {
+            GameArena::Scope scope(arena);
+            cards = CardLoader::createCardsFromConfig((*catalog)[0], 0).size();
+        }
+        if (cards == 0 || GameArena::current() == arena.resource()) {
+            println("{}✗ La arena no queda activa solo dentro del scope{}", RED, RESET);
+            return false;
+        }
+    }
+
+    // Desmontar una partida libera también lo que sus objetos guardan en el
+    // heap global (vectores de triggers, direcciones, mensajes): cada reserva
+    // de la partida tiene su liberación. La primera partida calienta las
+    // cachés de proceso
+    const GameState::DeckBuilder buildDecks = [&](PlayerId playerId) {
+        return CardLoader::createCardsFromConfig((*catalog)[playerId], playerId);
+    };
+    const GameConfig config;
+    size_t leaked = 0;
+    for (int game = 0; game < 2; ++game) {
+        const size_t allocations = heapAllocations, releases = heapReleases;
+        { GameState state(buildDecks, config); }
+        leaked = (heapAllocations - allocations) - (heapReleases - releases);
+    }
+    if (leaked != 0) {
+        println("{}✗ Desmontar una partida deja {} reservas del heap sin liberar{}", RED, leaked, RESET);
+        return false;
+    }
+
+    constexpr size_t ITERATIONS = 2'000;
+
+    double heap = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            auto deck0 = CardLoader::createCardsFromConfig((*catalog)[0], 0);
+            auto deck1 = CardLoader::createCardsFromConfig((*catalog)[1], 1);
+            acc += deck0.size() + deck1.size();
+        }
+        benchSink = acc;
+    });
+
+    double arena = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            GameArena gameArena;
+            GameArena::Scope scope(gameArena);
+            auto deck0 = CardLoader::createCardsFromConfig((*catalog)[0], 0);
+            auto deck1 = CardLoader::createCardsFromConfig((*catalog)[1], 1);
+            acc += deck0.size() + deck1.size();
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("mazos de una partida (make_shared)", heap);
+    printBenchResult("mazos de una partida (arena)", arena);
+    println("  Speedup: {}x", heap / arena);
+    return true;
+}
+
+// Réplica del selector anterior: un nodo de std::list por celda objetivo
+list<MapCell*> legacySelectAll(GameMap& map) {
+    list<MapCell*> targets;
+    for (CellIndex index = 0; index < map.getCellCount(); ++index) {
+        MapCell* cell = map.at(index);
+        if (cell && cell->hasCard()) targets.push_back(cell);
+    }
+    return targets;
+}
+
+bool benchTargetLists() {
+    using namespace StrColors;
+    println("{}=== Objetivos: std::list vs SmallVector inline ==={}", BOLD, RESET);
+
+    // Añadir un elemento propio al crecer: se copia antes de soltar el buffer inline
+    SmallVector<string, 2> names{string(32, 'a'), string(32, 'b')};
+    names.push_back(names[0]);
+    names.push_back(names[1]);
+    if (names.size() != 4 || names[2] != string(32, 'a') || names[3] != string(32, 'b')) {
+        println("{}✗ SmallVector::push_back de un elemento propio al crecer{}", RED, RESET);
+        return false;
+    }
+
+    GameMap map;
+    GameMap::forEachCell(map.getEmptyMask(), [&](CellIndex index) {
+        map.placeCard(index, make_shared<Unit>(index, "U", 1, "", index & 1, 3, 5, 1, 1));
+    });
+    CardPtr source = map.getCard(CellIndex{0});
+    auto selector = TargetSelectorFactory::createAllCardsSelector(source, 0, AllCardsTargetSelector::FilterType::ALL_CARDS);
+    // Adyacentes a la unidad con más vecinas ocupadas
+    CellIndex center = 0;
+    GameMap::forEachCell(map.getOccupiedMask(), [&](CellIndex index) {
+        if (popcount(map.getNeighborMask(index) & map.getOccupiedMask()) >
+            popcount(map.getNeighborMask(center) & map.getOccupiedMask())) center = index;
+    });
+    auto centerUnit = dynamic_pointer_cast<Unit>(map.getCard(center));
+    const auto [centerX, centerY] = map.toCoordinates(center);
+    centerUnit->setPosition(centerX, centerY);
+    auto adjacent = TargetSelectorFactory::createAdjacentSelector(centerUnit, 0);
+
+    // Con el tablero lleno, seleccionar y aplicar no debe reservar memoria
+    const size_t before = heapAllocations;
+    size_t selected = 0, adjacentSelected = 0;
+    for (int i = 0; i < 100; ++i) {
+        CellList targets = selector->selectTargets(map, nullptr);
+        map.getUnitStats().addAttack(map.selectUnits(targets), i & 1 ? 1 : -1);
+        selected += targets.size();
+        adjacentSelected += adjacent->selectTargets(map, nullptr).size();
+    }
+    if (heapAllocations != before || selected != 100 * legacySelectAll(map).size() ||
+        adjacentSelected != 100 * static_cast<size_t>(popcount(map.getNeighborMask(center) & map.getOccupiedMask()))) {
+        println("{}✗ Seleccionar objetivos reservó {} bloques en el heap{}", RED, heapAllocations - before, RESET);
+        return false;
+    }
+
+    constexpr size_t ITERATIONS = 500'000;
+
+    double lists = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i) acc += legacySelectAll(map).size();
+        benchSink = acc;
+    });
+
+    double inlineVectors = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i) acc += selector->selectTargets(map, nullptr).size();
+        benchSink = acc;
+    });
+
+    printBenchResult("todas las cartas (std::list)", lists);
+    printBenchResult("todas las cartas (SmallVector)", inlineVectors);
+    println("  Speedup: {}x", lists / inlineVectors);
+    return true;
+}
+
+// Nombres de selector como antes del internado: un std::string por instancia
+struct LegacyNamedSelector {
+    string name;
+    explicit LegacyNamedSelector(const string& selectorName) : name(selectorName) {}
+};
+
+bool benchSymbols() {
+    using namespace StrColors;
+    println("{}=== Nombres: std::string por instancia vs Symbol internado ==={}", BOLD, RESET);
+
+    // El mismo texto debe resolver siempre a la misma copia
+    CardPtr source = make_shared<Unit>(1, "Caballero", 1, "", 0, 3, 5, 1, 1);
+    CardPtr other = make_shared<Unit>(2, "Caballero", 1, "", 1, 3, 5, 1, 1);
+    auto first = TargetSelectorFactory::createAllCardsSelector(source, 0, AllCardsTargetSelector::FilterType::ALL_CARDS);
+    auto second = TargetSelectorFactory::createAllCardsSelector(other, 0, AllCardsTargetSelector::FilterType::ALL_CARDS);
+    if (!(first->getSymbol() == second->getSymbol()) || &source->getName() != &other->getName() ||
+        Symbol(string("Caballero")) != Symbol("Caballero")) {
+        println("{}✗ Un mismo nombre se internó dos veces{}", RED, RESET);
+        return false;
+    }
+
+    constexpr size_t ITERATIONS = 2'000'000;
+    const string legacyName = "AllCardsTargetSelector con un nombre largo";
+
+    double strings = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            LegacyNamedSelector selector(legacyName);
+            acc += selector.name == legacyName;
+        }
+        benchSink = acc;
+    });
+
+    double symbols = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            Symbol name = "AllCardsTargetSelector con un nombre largo"_sym;
+            acc += name == "AllCardsTargetSelector con un nombre largo"_sym;
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("crear y comparar nombre (std::string)", strings);
+    printBenchResult("crear y comparar nombre (Symbol)", symbols);
+    println("  Speedup: {}x", strings / symbols);
+    return true;
+}
+
+// Primera unidad de la mano del jugador colocada junto a su leyenda
+bool playFirstUnit(GameState& game, PlayerId playerId) {
+    const uint64_t placement = game.getMap().getPlacementMask(playerId);
+    if (!placement) return false;
+    for (const CardPtr& card : game.getPlayer(playerId).hand) {
+        if (!card->isUnit() || card->isLegend()) continue;
+        auto [x, y] = game.getMap().toCoordinates(static_cast<CellIndex>(countr_zero(placement)));
+        game.playCard(playerId, card, x, y);
+        return true;
+    }
+    return false;
+}
+
+// Ninguna carta (ni la fuente de sus efectos) del clon puede ser de la original
+bool sharesNoCards(const GameState& original, const GameState& copy) {
+    bool independent = true;
+    GameMap::forEachCell(copy.getMap().getOccupiedMask(), [&](CellIndex index) {
+        const CardPtr& card = copy.getMap().getCard(index);
+        independent = independent && card != original.getMap().getCard(index);
+        for (const EffectPtr& effect : card->getEffects()) {
+            independent = independent && effect->getSource() == card;
+        }
+    });
+    for (PlayerId id : {0u, 1u}) {
+        const auto& hand = copy.getPlayer(id).hand;
+        for (size_t i = 0; i < hand.size(); ++i) {
+            independent = independent && hand[i] != original.getPlayer(id).hand[i];
+        }
+    }
+    return independent;
+}
+
+bool benchGameClone() {
+    using namespace StrColors;
+    println("{}=== Copias de partida: clone() profundo ==={}", BOLD, RESET);
+
+    auto catalog = CardLoader::loadCatalog("decks.json");
+    if (catalog->size() < 2) {
+        println("{}✗ No se pudieron cargar los mazos de decks.json{}", RED, RESET);
+        return false;
+    }
+    auto game = make_shared<GameState>([&](PlayerId playerId) {
+        return CardLoader::createCardsFromConfig((*catalog)[playerId], playerId);
+    }, GameConfig());
+    playFirstUnit(*game, 0);
+
+    // El clon profundo es idéntico (mismo hash) e independiente de la original
+    auto copy = game->clone();
+    const uint64_t originalHash = game->getStateHash();
+    if (copy->getStateHash() != originalHash || copy->computeStateHash() != originalHash ||
+        !sharesNoCards(*game, *copy)) {
+        println("{}✗ clone() no reproduce la partida o comparte cartas con ella{}", RED, RESET);
+        return false;
+    }
+    copy->endTurn(0);
+    playFirstUnit(*copy, 1);
+    if (game->getStateHash() != originalHash || copy->getStateHash() != copy->computeStateHash()) {
+        println("{}✗ Jugar en el clon modificó la partida original{}", RED, RESET);
+        return false;
+    }
+
+    constexpr size_t ITERATIONS = 20'000;
+
+    double deep = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) acc += game->clone()->getStateHash();
+        benchSink = acc;
+    });
+
+    printBenchResult("clone() profundo", deep);
+    println("  Copias por segundo: {}", static_cast<uint64_t>(1e9 / deep));
+    return true;
+}
+
+// Estado observable de una partida: hash, manos y mazos (por identidad de carta)
+struct GameSnapshot {
+    uint64_t hash;
+    array<vector<CardPtr>, 2> hands;
+    array<vector<CardPtr>, 2> decks;
+
+    explicit GameSnapshot(const GameState& game) : hash(game.computeStateHash()) {
+        for (PlayerId id : {0u, 1u}) {
+            hands[id] = game.getPlayer(id).hand;
+            decks[id] = game.getPlayer(id).deck;
+        }
+    }
+    bool operator==(const GameSnapshot&) const = default;
+};
+
+// Una acción válida del jugador actual: jugar, atacar, mover o terminar el turno
+void playOneAction(GameState& game, int step) {
+    const PlayerId player = game.getCurrentPlayer();
+    const GameMap& map = game.getMap();
+    if (game.getActionsRemaining(player) > 0) {
+        if (step % 3 == 0 && playFirstUnit(game, player)) return;
+        bool acted = false;
+        GameMap::forEachCell(map.getOccupancyMask(player), [&](CellIndex index) {
+            if (acted) return;
+            auto unit = dynamic_pointer_cast<Unit>(map.getCard(index));
+            if (!unit || unit->isLegend()) return;
+            if (uint64_t targets = map.getAttackMask(index, unit->getRange(), player)) {
+                auto [x, y] = map.toCoordinates(static_cast<CellIndex>(countr_zero(targets)));
+                acted = game.attackWithCard(player, unit, x, y);
+            } else if (uint64_t reachable = game.getReachableMask(unit)) {
+                auto [x, y] = map.toCoordinates(static_cast<CellIndex>(63 - countl_zero(reachable)));
+                acted = game.moveCard(player, unit, x, y);
+            }
+        });
+        if (acted) return;
+    }
+    game.endTurn(player);
+}
+
+bool benchUndoJournal() {
+    using namespace StrColors;
+    println("{}=== Deshacer jugadas: clone() vs journal make/unmake ==={}", BOLD, RESET);
+
+    // Mapa: colocar, kernels de estadísticas, mover y quitar se deshacen exactos
+    GameMap map;
+    GameJournal mapJournal;
+    map.setJournal(&mapJournal);
+    array<CellIndex, 5> cells{};
+    uint64_t free = map.getEmptyMask();
+    for (CellIndex& index : cells) {
+        index = static_cast<CellIndex>(countr_zero(free));
+        free &= free - 1;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        map.placeCard(cells[i], make_shared<Unit>(cells[i], "U", 1, "", i & 1, 3, 6, 1, 1));
+    }
+    const uint64_t initialBoard = map.getBoardHash();
+    const size_t initialEntries = mapJournal.size();
+    const auto initialHealth = map.getUnitStats().health;
+
+    const list<MapCell*> targets = {map.at(cells[0]), map.at(cells[2])};
+    map.getUnitStats().addHealth(map.selectUnits(targets), -4);
+    map.getUnitStats().addAttack(map.selectUnits(targets), 2);
+    for (MapCell* cell : targets) map.refreshUnit(cell);
+    map.moveCard(cells[1], cells[4]);
+    map.removeCard(cells[3]);
+    map.placeCard(cells[3], make_shared<Unit>(40, "U", 1, "", 1, 1, 1, 1, 1));
+    const size_t recorded = mapJournal.size() - initialEntries;
+    while (mapJournal.size() > initialEntries) {
+        map.undo(mapJournal.back());
+        mapJournal.pop();
+    }
+    // 4 STAT (2 celdas x 2 kernels), 2 REHASH, MOVE, REMOVE y PLACE
+    if (recorded != 9 || map.getBoardHash() != initialBoard || map.computeBoardHash() != initialBoard ||
+        map.getUnitStats().health != initialHealth || !map.getCard(cells[1]) || map.getCard(cells[4])) {
+        println("{}✗ GameMap::undo no restaura el tablero{}", RED, RESET);
+        return false;
+    }
+
+    // Partida: cada acción se deshace hasta el estado exacto anterior
+    auto catalog = CardLoader::loadCatalog("decks.json");
+    if (catalog->size() < 2) {
+        println("{}✗ No se pudieron cargar los mazos de decks.json{}", RED, RESET);
+        return false;
+    }
+    auto game = make_shared<GameState>([&](PlayerId playerId) {
+        return CardLoader::createCardsFromConfig((*catalog)[playerId], playerId);
+    }, GameConfig());
+    game->enableJournal();
+
+    vector<GameSnapshot> history;
+    for (int step = 0; step < 40 && !game->isGameOver(); ++step) {
+        history.emplace_back(*game);
+        playOneAction(*game, step);
+        if (game->getStateHash() != game->computeStateHash()) {
+            println("{}✗ Hash incremental incorrecto tras la acción {}{}", RED, step, RESET);
+            return false;
+        }
+    }
+    if (game->getUndoDepth() != history.size()) {
+        println("{}✗ Se registraron {} acciones de {}{}", RED, game->getUndoDepth(), history.size(), RESET);
+        return false;
+    }
+    while (!history.empty()) {
+        game->undo();
+        if (GameSnapshot(*game) != history.back() || game->getStateHash() != history.back().hash) {
+            println("{}✗ undo() no restaura la partida ({} acciones restantes){}", RED, history.size() - 1, RESET);
+            return false;
+        }
+        history.pop_back();
+    }
+
+    // Tras calentar el journal, terminar turno y deshacerlo no reserva memoria
+    playFirstUnit(*game, 0);
+    const GameSnapshot start(*game);
+    for (int warmup = 0; warmup < 4; ++warmup) {
+        game->endTurn(game->getCurrentPlayer());
+        game->undo();
+    }
+    const size_t before = heapAllocations;
+    for (int i = 0; i < 100; ++i) {
+        game->endTurn(game->getCurrentPlayer());
+        game->undo();
+    }
+    if (heapAllocations != before || GameSnapshot(*game) != start) {
+        println("{}✗ endTurn+undo reservó {} bloques en el heap{}", RED, heapAllocations - before, RESET);
+        return false;
+    }
+
+    constexpr size_t ITERATIONS = 20'000;
+
+    double copies = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            auto child = game->clone();
+            child->endTurn(child->getCurrentPlayer());
+            acc += child->getStateHash();
+        }
+        benchSink = acc;
+    });
+
+    double journal = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            game->endTurn(game->getCurrentPlayer());
+            acc += game->getStateHash();
+            game->undo();
+        }
+        benchSink = acc;
+    });
+
+    printBenchResult("clone() + endTurn", copies);
+    printBenchResult("endTurn + undo()", journal);
+    println("  Speedup: {}x", copies / journal);
+    return true;
+}
+
+// Auras: la capa de modificadores frente a sumar y restar sobre el valor base
+bool benchStatModifiers() {
+    using namespace StrColors;
+    println("{}=== Auras: capa de modificadores vs reescribir el valor base ==={}", BOLD, RESET);
+
+    GameMap map;
+    GameJournal journal;
+    map.setJournal(&journal);
+    // Fuente en la celda con más vecinas libres
+    CellIndex center = 0;
+    GameMap::forEachCell(map.getEmptyMask(), [&](CellIndex index) {
+        if (popcount(map.getNeighborMask(index) & map.getEmptyMask()) >
+            popcount(map.getNeighborMask(center) & map.getEmptyMask())) center = index;
+    });
+    map.placeCard(center, make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1));
+    const EntityId source = map.at(center)->entity;
+    // Claves de dos efectos de la misma fuente
+    constexpr UnitStatStore::AuraKey AURA = 1, OTHER_AURA = 2;
+    list<MapCell*> targets;
+    GameMap::forEachCell(map.getNeighborMask(center) & map.getEmptyMask(), [&](CellIndex index) {
+        map.placeCard(index, make_shared<Unit>(index, "U", 1, "", 0, 1, 5, 1, 1));
+        targets.push_back(map.at(index));
+    });
+    uint64_t targetSlots = 0;
+    for (const MapCell* cell : targets) targetSlots |= uint64_t{1} << UnitStatStore::slotOf(cell->entity);
+    const UnitStatStore& stats = map.getUnitStats();
+    auto attackAt = [&](const MapCell* cell) { return stats.get(&UnitStatStore::attack, cell->entity); };
+
+    // Aura -3 sobre ataque 1: el efectivo queda en 0 y el base no cambia
+    const uint64_t initialBoard = map.getBoardHash();
+    const size_t initialEntries = journal.size();
+    map.setAura(AURA, source, &UnitStatStore::attack, targets, -3);
+    bool ok = attackAt(targets.front()) == 0 && stats.base(&UnitStatStore::attack, targets.front()->entity) == 1;
+    // Un kernel cambia el base por debajo del aura
+    map.getUnitStats().addAttack(map.selectUnits(targets), 4);
+    for (MapCell* cell : targets) map.refreshUnit(cell);
+    ok = ok && attackAt(targets.front()) == 2 && map.getBoardHash() == map.computeBoardHash();
+    // Reevaluar el aura la sustituye; retirar la fuente la quita
+    map.setAura(AURA, source, &UnitStatStore::attack, targets, 1);
+    ok = ok && stats.getModifierCount() == targets.size() && attackAt(targets.front()) == 6;
+    // Otro efecto de la misma fuente sobre la misma estadística se suma, y
+    // retirarlo no toca el primero
+    map.setAura(OTHER_AURA, source, &UnitStatStore::attack, targets, 2);
+    ok = ok && stats.getModifierCount() == 2 * targets.size() && attackAt(targets.front()) == 8;
+    map.removeModifiers(OTHER_AURA);
+    ok = ok && stats.getModifierCount() == targets.size() && attackAt(targets.front()) == 6;
+    map.setAura(OTHER_AURA, source, &UnitStatStore::attack, targets, 2);
+    // Quitar el primero (por su índice) conserva el otro
+    map.removeModifiers(AURA);
+    ok = ok && stats.getModifierCount() == targets.size() && attackAt(targets.front()) == 7 &&
+         stats.hasAura(OTHER_AURA, &UnitStatStore::attack, targetSlots, 2);
+    map.removeCard(center);
+    ok = ok && stats.getModifierCount() == 0 && attackAt(targets.front()) == 5 &&
+         map.getBoardHash() == map.computeBoardHash();
+    while (journal.size() > initialEntries) {
+        map.undo(journal.back());
+        journal.pop();
+    }
+    ok = ok && map.getBoardHash() == initialBoard && map.computeBoardHash() == initialBoard &&
+         stats.getModifierCount() == 0 && attackAt(targets.front()) == 1;
+    // Sumar y restar sobre el base pierde información al saturar en 0
+    const auto selection = map.selectUnits(targets);
+    map.getUnitStats().addAttack(selection, -3);
+    map.getUnitStats().addAttack(selection, 3);
+    ok = ok && attackAt(targets.front()) == 3;
+    if (!ok) {
+        println("{}✗ Valores efectivos de la capa de modificadores incorrectos{}", RED, RESET);
+        return false;
+    }
+    map.setJournal(nullptr);
+    map.placeCard(center, make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1));
+    const EntityId aura = map.at(center)->entity;
+
+    constexpr size_t ITERATIONS = 500'000;
+
+    // Aplicar el aura, leer el ataque de sus objetivos y expirarla
+    double rewrite = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const auto selected = map.selectUnits(targets);
+            map.getUnitStats().addAttack(selected, 2);
+            for (MapCell* cell : targets) { map.refreshUnit(cell); acc += attackAt(cell); }
+            map.getUnitStats().addAttack(selected, -2);
+            for (MapCell* cell : targets) map.refreshUnit(cell);
+        }
+        benchSink = acc;
+    });
+
+    double layered = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            map.setAura(AURA, aura, &UnitStatStore::attack, targets, 2);
+            for (MapCell* cell : targets) acc += attackAt(cell);
+            map.removeModifiers(AURA);
+        }
+        benchSink = acc;
+    });
+
+    // Aura persistente reevaluada cada turno con los mismos objetivos: sobre
+    // el base hay que deshacer la anterior y volver a aplicarla
+    double rewriteKept = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        const auto selected = map.selectUnits(targets);
+        map.getUnitStats().addAttack(selected, 2);
+        for (size_t i = 0; i < n; ++i) {
+            map.getUnitStats().addAttack(map.selectUnits(targets), -2);
+            map.getUnitStats().addAttack(map.selectUnits(targets), 2);
+            for (MapCell* cell : targets) { map.refreshUnit(cell); acc += attackAt(cell); }
+        }
+        map.getUnitStats().addAttack(selected, -2);
+        benchSink = acc;
+    });
+
+    double layeredKept = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            map.setAura(AURA, aura, &UnitStatStore::attack, targets, 2);
+            for (MapCell* cell : targets) acc += attackAt(cell);
+        }
+        map.removeModifiers(AURA);
+        benchSink = acc;
+    });
+
+    // Quitar las auras de un efecto va por su índice: no depende de cuántos
+    // modificadores de otros efectos haya activos
+    auto setAndRemove = [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            map.setAura(AURA, aura, &UnitStatStore::attack, targets, 2);
+            map.removeModifiers(AURA);
+        }
+        benchSink = stats.getModifierCount();
+    };
+    double alone = measureNanosPerOp(ITERATIONS, setAndRemove);
+    constexpr UnitStatStore::AuraKey CROWD = 64;
+    for (UnitStatStore::AuraKey key = 0; key < CROWD; ++key) {
+        map.setAura(OTHER_AURA + 1 + key, aura, &UnitStatStore::speed, targets, 1);
+    }
+    const size_t crowdModifiers = stats.getModifierCount();
+    double crowded = measureNanosPerOp(ITERATIONS, setAndRemove);
+    for (UnitStatStore::AuraKey key = 0; key < CROWD; ++key) map.removeModifiers(OTHER_AURA + 1 + key);
+    if (crowdModifiers != CROWD * targets.size() || stats.getModifierCount() != 0) {
+        println("{}✗ El índice por clave no quitó las auras de cada efecto{}", RED, RESET);
+        return false;
+    }
+
+    printBenchResult("aplicar y expirar (sumando/restando el base)", rewrite);
+    printBenchResult("aplicar y expirar (capa de modificadores)", layered);
+    printBenchResult("aplicar y quitar un aura (sin otras activas)", alone);
+    printBenchResult(format("aplicar y quitar un aura ({} modificadores de otros efectos)", crowdModifiers), crowded);
+    printBenchResult("reevaluar aura persistente (sumando/restando el base)", rewriteKept);
+    printBenchResult("reevaluar aura persistente (capa de modificadores)", layeredKept);
+    println("  Speedup: {}x", rewriteKept / layeredKept);
+    return true;
+}
+
+// Réplica de expirar recorriendo la pila entera: el turno de expiración de
+// cada efecto (UINT32_MAX si es persistente) y en cada fin de turno se
+// revisan todos y se quitan los vencidos
+struct LegacyExpiryStack {
+    EffectStack stack;
+    ska::flat_hash_map<uint32_t, uint32_t> expiryById;
+    vector<uint32_t> expired;
+
+    void add(const EffectPtr& effect, uint32_t expiry) { expiryById[stack.addEffect(effect)] = expiry; }
+
+    void expireTurn(uint32_t turn) {
+        expired.clear();
+        for (const auto& [id, expiry] : expiryById) {
+            if (expiry == turn) expired.push_back(id);
+        }
+        for (uint32_t id : expired) {
+            stack.removeEffect(id);
+            expiryById.erase(id);
+        }
+    }
+};
+
+bool benchEffectExpiry() {
+    using namespace StrColors;
+    println("{}=== Duración de efectos: rueda por turno vs recorrer la pila ==={}", BOLD, RESET);
+
+    // Un aura con duración 2 se retira de la pila y del mapa al expirar
+    GameMap map;
+    CellIndex center = 0;
+    GameMap::forEachCell(map.getEmptyMask(), [&](CellIndex index) {
+        if (popcount(map.getNeighborMask(index) & map.getEmptyMask()) >
+            popcount(map.getNeighborMask(center) & map.getEmptyMask())) center = index;
+    });
+    auto source = make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1);
+    map.placeCard(center, source);
+    const CellIndex neighbor = static_cast<CellIndex>(countr_zero(map.getNeighborMask(center) & map.getEmptyMask()));
+    map.placeCard(neighbor, make_shared<Unit>(1, "U", 1, "", 0, 1, 5, 1, 1));
+    auto target = dynamic_pointer_cast<Unit>(map.getCard(neighbor));
+
+    auto aura = make_shared<ComposedEffect>(make_shared<AttackModifierEffectImpl>(source, 0, 2, true),
+                                            TriggerFactory::createOnPlayTrigger(source, 0),
+                                            TargetSelectorFactory::createSelfSelector(source, 0), source, 0);
+    aura->setDuration(2);
+    EffectStack stack;
+    stack.scheduleExpiry(stack.addEffect(aura), static_cast<uint32_t>(aura->getDuration()));
+    CellList cells;
+    cells.push_back(map.at(neighbor));
+    aura->getEffectImpl()->apply(map, nullptr, cells);
+    const bool applied = target->getAttack() == 3;
+    stack.expireTurn(0, map);
+    stack.expireTurn(1, map);
+    const bool kept = stack.getEffectCount() == 1 && target->getAttack() == 3;
+    stack.expireTurn(2, map);
+    if (!applied || !kept || stack.getEffectCount() != 0 || stack.getScheduledCount() != 0 ||
+        target->getAttack() != 1 || map.getBoardHash() != map.computeBoardHash()) {
+        println("{}✗ El aura no expira a los 2 turnos{}", RED, RESET);
+        return false;
+    }
+
+    // Dos efectos de la misma carta sobre el ataque: cada uno es su propia
+    // aura y expirar uno no retira el otro
+    auto first = make_shared<AttackModifierEffectImpl>(source, 0, 2, true);
+    auto second = make_shared<AttackModifierEffectImpl>(source, 0, 1, true);
+    first->apply(map, nullptr, cells);
+    second->apply(map, nullptr, cells);
+    const bool stacked = target->getAttack() == 4;
+    first->expire(map);
+    const bool keptOther = target->getAttack() == 2;
+    second->expire(map);
+    // Un buff permanente (duration -1) también es un aura: reevaluarlo no lo
+    // acumula y el valor base no cambia. Uno instantáneo (0) cambia el base
+    const auto [sourceX, sourceY] = map.toCoordinates(center);
+    source->setPosition(sourceX, sourceY);
+    auto buffFor = [&](int duration) {
+        return ComposedEffectFactory::createFromConfig(
+            ConfigLexer::EffectType::ATTRIBUTE_MODIFIER, ConfigLexer::TriggerType::ON_PLAY,
+            ConfigLexer::TargetType::SELF, source, 0, 2, ConfigLexer::TargetFilter::ANY, {}, "attack", 0, 0, duration);
+    };
+    auto permanent = buffFor(-1);
+    permanent->resolve(map, map.at(center), nullptr);
+    permanent->resolve(map, map.at(center), nullptr);
+    const bool permanentAura = map.getUnitStats().base(&UnitStatStore::attack, source->getEntity()) == 2 &&
+                               source->getAttack() == 4 && map.getUnitStats().getModifierCount() == 1;
+    permanent->expire(map);
+    buffFor(0)->resolve(map, map.at(center), nullptr);
+    const bool instantBase = map.getUnitStats().base(&UnitStatStore::attack, source->getEntity()) == 4 &&
+                             map.getUnitStats().getModifierCount() == 0;
+    if (!stacked || !keptOther || target->getAttack() != 1 || !permanentAura || !instantBase ||
+        map.getBoardHash() != map.computeBoardHash()) {
+        println("{}✗ Auras de una misma carta mal separadas o buff permanente fuera de la capa de modificadores{}", RED, RESET);
+        return false;
+    }
+
+    // Partida larga: 200 efectos persistentes y 8 nuevos por turno con
+    // duraciones 0-3; la pila solo conserva los vigentes
+    constexpr size_t PERSISTENT = 200;
+    constexpr uint32_t PER_TURN = 8;
+    LegacyExpiryStack legacy;
+    for (size_t i = 0; i < PERSISTENT; ++i) {
+        stack.addEffect(aura);
+        legacy.add(aura, UINT32_MAX);
+    }
+    for (uint32_t turn = 0; turn < 50; ++turn) {
+        for (uint32_t i = 0; i < PER_TURN; ++i) {
+            stack.scheduleExpiry(stack.addEffect(aura), turn + i % 4);
+            legacy.add(aura, turn + i % 4);
+        }
+        stack.expireTurn(turn, map);
+        legacy.expireTurn(turn);
+        if (stack.getEffectCount() != legacy.stack.getEffectCount() ||
+            stack.getEffectCount() != PERSISTENT + stack.getScheduledCount()) {
+            println("{}✗ Turno {}: {} efectos en la pila, se esperaban {}{}", RED, turn,
+                    stack.getEffectCount(), legacy.stack.getEffectCount(), RESET);
+            return false;
+        }
+    }
+
+    constexpr size_t ITERATIONS = 200'000;
+    uint32_t wheelTurn = 50, legacyTurn = 50;
+
+    double scan = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t t = 0; t < n; ++t, ++legacyTurn) {
+            for (uint32_t i = 0; i < PER_TURN; ++i) legacy.add(aura, legacyTurn + i % 4);
+            legacy.expireTurn(legacyTurn);
+        }
+        benchSink = legacy.stack.getEffectCount();
+    });
+
+    double wheel = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t t = 0; t < n; ++t, ++wheelTurn) {
+            for (uint32_t i = 0; i < PER_TURN; ++i) stack.scheduleExpiry(stack.addEffect(aura), wheelTurn + i % 4);
+            stack.expireTurn(wheelTurn, map);
+        }
+        benchSink = stack.getEffectCount();
+    });
+
+    printBenchResult("fin de turno (recorrer la pila)", scan);
+    printBenchResult("fin de turno (rueda por turno)", wheel);
+    println("  Speedup: {}x", scan / wheel);
+    return true;
+}
+
+// Réplica de la pila anterior: id -> cubo en un ska::flat_hash_map y cubos
+// ordenados por id (búsqueda binaria y borrado desplazando la cola)
+struct LegacyIdStack {
+    struct Entry {
+        uint32_t id;
+        EffectPtr effect;
+    };
+    array<vector<Entry>, static_cast<size_t>(TriggerAction::MAX_ACTIONS)> buckets;
+    ska::flat_hash_map<uint32_t, TriggerAction> bucketOf;
+    uint32_t nextId = 1;
+
+    uint32_t add(EffectPtr effect, TriggerAction trigger) {
+        buckets[static_cast<size_t>(trigger)].push_back({nextId, std::move(effect)});
+        bucketOf[nextId] = trigger;
+        return nextId++;
+    }
+
+    vector<Entry>::iterator locate(uint32_t id, vector<Entry>& bucket) {
+        auto entry = lower_bound(bucket.begin(), bucket.end(), id,
+                                 [](const Entry& candidate, uint32_t wanted) { return candidate.id < wanted; });
+        return entry != bucket.end() && entry->id == id ? entry : bucket.end();
+    }
+
+    void remove(uint32_t id) {
+        auto it = bucketOf.find(id);
+        if (it == bucketOf.end()) return;
+        auto& bucket = buckets[static_cast<size_t>(it->second)];
+        auto entry = locate(id, bucket);
+        if (entry != bucket.end()) bucket.erase(entry);
+        bucketOf.erase(it);
+    }
+
+    const Effect* get(uint32_t id) {
+        auto it = bucketOf.find(id);
+        if (it == bucketOf.end()) return nullptr;
+        auto& bucket = buckets[static_cast<size_t>(it->second)];
+        auto entry = locate(id, bucket);
+        return entry != bucket.end() ? entry->effect.get() : nullptr;
+    }
+};
+
+bool benchEffectHandles() {
+    using namespace StrColors;
+    println("{}=== Pila de efectos: slot map generacional vs ids en hash map ==={}", BOLD, RESET);
+
+    auto source = make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1);
+    auto makeEffect = [&](int change) {
+        return make_shared<ComposedEffect>(make_shared<AttackModifierEffectImpl>(source, 0, change),
+                                           TriggerFactory::createOnPlayTrigger(source, 0),
+                                           TargetSelectorFactory::createSelfSelector(source, 0), source, 0);
+    };
+
+    // Handles válidos, obsoletos tras quitar el efecto y reutilización del slot
+    EffectStack stack;
+    GameJournal journal;
+    EffectPtr first = makeEffect(1), second = makeEffect(2), third = makeEffect(3);
+    const EffectHandle a = stack.addEffect(first, TriggerAction::ON_PLAY);
+    const EffectHandle b = stack.addEffect(second, TriggerAction::ON_END_OF_TURN);
+    bool ok = a != NO_EFFECT && b != NO_EFFECT && a != b &&
+              stack.getEffect(a) == first && stack.getEffect(b) == second;
+    stack.setJournal(&journal);
+    stack.removeEffect(a);
+    stack.removeEffect(a);  // Handle obsoleto: no hace nada
+    const EffectHandle c = stack.addEffect(third, TriggerAction::ON_PLAY);
+    ok = ok && !stack.contains(a) && stack.getEffect(a) == nullptr && c != a &&
+         stack.getEffect(c) == third && stack.getEffectCount() == 2 &&
+         stack.getEffectCount(TriggerAction::ON_PLAY) == 1;
+    while (!journal.empty()) {
+        stack.undo(journal.back());
+        journal.pop();
+    }
+    ok = ok && stack.getEffect(a) == first && !stack.contains(c) && stack.getEffectCount() == 2;
+    stack.setJournal(nullptr);
+    if (!ok) {
+        println("{}✗ Handles del slot map incorrectos{}", RED, RESET);
+        return false;
+    }
+
+    // Pila de 256 efectos con rotación: quitar uno antiguo, añadir otro y consultar
+    constexpr size_t LIVE = 256;
+    constexpr size_t ITERATIONS = 1'000'000;
+    const EffectPtr effect = makeEffect(1);
+    constexpr array<TriggerAction, 2> triggers = {TriggerAction::ON_PLAY, TriggerAction::ON_END_OF_TURN};
+    vector<EffectHandle> handles;
+    vector<uint32_t> ids;
+    LegacyIdStack legacy;
+    for (size_t i = 0; i < LIVE; ++i) {
+        handles.push_back(stack.addEffect(effect, triggers[i & 1]));
+        ids.push_back(legacy.add(effect, triggers[i & 1]));
+    }
+
+    double hashed = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uintptr_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t victim = (i * 97) % LIVE;
+            legacy.remove(ids[victim]);
+            ids[victim] = legacy.add(effect, triggers[i & 1]);
+            acc += reinterpret_cast<uintptr_t>(legacy.get(ids[(i * 31) % LIVE]));
+        }
+        benchSink = acc;
+    });
+
+    double slots = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        uintptr_t acc = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t victim = (i * 97) % LIVE;
+            stack.removeEffect(handles[victim]);
+            handles[victim] = stack.addEffect(effect, triggers[i & 1]);
+            acc += reinterpret_cast<uintptr_t>(stack.getEffect(handles[(i * 31) % LIVE]).get());
+        }
+        benchSink = acc;
+    });
+
+    // Los dos efectos de la comprobación anterior siguen en la pila
+    if (stack.getEffectCount() != LIVE + 2) {
+        println("{}✗ La pila tiene {} efectos, se esperaban {}{}", RED, stack.getEffectCount(), LIVE + 2, RESET);
+        return false;
+    }
+
+    printBenchResult("quitar+añadir+consultar (ids en hash map)", hashed);
+    printBenchResult("quitar+añadir+consultar (slot map)", slots);
+    println("  Speedup: {}x", hashed / slots);
+    return true;
+}
+
+bool benchTriggerBuckets() {
+    using namespace StrColors;
+    println("{}=== Cubos de trigger: registrar por acción vs todo en ON_PLAY ==={}", BOLD, RESET);
+
+    GameMap map;
+    const CellIndex cell = static_cast<CellIndex>(countr_zero(map.getEmptyMask()));
+    auto source = make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1);
+    map.placeCard(cell, source);
+    const auto [sourceX, sourceY] = map.toCoordinates(cell);
+    source->setPosition(sourceX, sourceY);
+    // Aura de ataque sobre la propia fuente: reaplicarla con el mismo valor no cambia nada
+    auto makeEffect = [&](vector<TriggerPtr> triggers, int change) {
+        return make_shared<ComposedEffect>(make_shared<AttackModifierEffectImpl>(source, 0, change, true), triggers,
+                                           TargetSelectorFactory::createSelfSelector(source, 0), source, 0);
+    };
+    const TriggerPtr onPlay = TriggerFactory::createOnPlayTrigger(source, 0);
+    const TriggerPtr onEndTurn = TriggerFactory::createOnEndTurnTrigger(source, 0);
+    const TriggerPtr onStartTurn = TriggerFactory::createOnStartTurnTrigger(source, 0);
+    const TriggerPtr onEnter = TriggerFactory::createOnEnemyEnterTrigger(source, 0, GameMap::Adjacency::UP);
+
+    // Cada efecto queda en los cubos de sus triggers y solo se procesa en ellos
+    EffectStack stack;
+    const EffectHandles endHandles = stack.addComposedEffect(makeEffect({onEndTurn}, 1));
+    const EffectHandles bothHandles = stack.addComposedEffect(makeEffect({onPlay, onStartTurn}, 5));
+    bool ok = endHandles.size() == 1 && bothHandles.size() == 2 &&
+              stack.getEffectCount(TriggerAction::ON_END_OF_TURN) == 1 &&
+              stack.getEffectCount(TriggerAction::ON_PLAY) == 1 &&
+              stack.getEffectCount(TriggerAction::ON_START_OF_TURN) == 1 && stack.getEffectCount() == 3;
+    stack.processEndOfTurn(map);
+    ok = ok && source->getAttack() == 3;
+    // Cada efecto mantiene su propia aura: se suman y reevaluar una no toca la otra
+    stack.processOnPlay(map, map.at(cell), nullptr);
+    ok = ok && source->getAttack() == 8;
+    stack.processEndOfTurn(map);
+    ok = ok && source->getAttack() == 8 && map.getBoardHash() == map.computeBoardHash();
+    // En ON_PLAY, un trigger de entrada que no se activa sacaba su efecto de la pila
+    stack.addComposedEffect(makeEffect({onEnter}, 1));
+    stack.processOnPlay(map, map.at(cell), nullptr);
+    ok = ok && stack.getEffectCount(TriggerAction::ON_POSITION_ENTER) == 1 && stack.getEffectCount() == 4;
+    if (!ok) {
+        println("{}✗ Efectos registrados o procesados en cubos incorrectos{}", RED, RESET);
+        return false;
+    }
+
+    // 64 efectos, 8 de ellos al jugar: antes todos esperaban en ON_PLAY (y
+    // los de turno se aplicaban al jugar). Sin triggers de entrada, que el
+    // recorrido de ON_PLAY retiraría y la pila legacy iría encogiendo
+    constexpr size_t EFFECTS = 64;
+    const array<TriggerPtr, 3> kinds = {onPlay, onEndTurn, onStartTurn};
+    EffectStack bucketed, legacy;
+    for (size_t i = 0; i < EFFECTS; ++i) {
+        const EffectPtr effect = makeEffect({kinds[i % 8 == 0 ? 0 : 1 + i % 2]}, 1);
+        bucketed.addTriggeredEffect(effect);
+        legacy.addEffect(effect, TriggerAction::ON_PLAY);
+    }
+    if (bucketed.getEffectCount(TriggerAction::ON_PLAY) != EFFECTS / 8 ||
+        legacy.getEffectCount(TriggerAction::ON_PLAY) != EFFECTS) {
+        println("{}✗ Reparto de efectos por cubo incorrecto{}", RED, RESET);
+        return false;
+    }
+
+    constexpr size_t ITERATIONS = 200'000;
+    double all = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) legacy.processOnPlay(map, map.at(cell), nullptr);
+        benchSink = source->getAttack();
+    });
+
+    double bucketedPass = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) bucketed.processOnPlay(map, map.at(cell), nullptr);
+        benchSink = source->getAttack();
+    });
+
+    if (legacy.getEffectCount() != EFFECTS || bucketed.getEffectCount() != EFFECTS) {
+        println("{}✗ El procesado retiró efectos de la pila{}", RED, RESET);
+        return false;
+    }
+
+    printBenchResult("procesar ON_PLAY (todos en ON_PLAY)", all);
+    printBenchResult("procesar ON_PLAY (cubos por trigger)", bucketedPass);
+    println("  Speedup: {}x", all / bucketedPass);
+    return true;
+}
+
+bool benchCellSubscriptions() {
+    using namespace StrColors;
+    println("{}=== Triggers de posición: suscripciones por celda vs evaluar todos ==={}", BOLD, RESET);
+
+    constexpr array<GameMap::Adjacency, 6> ALL_DIRECTIONS = {
+        GameMap::Adjacency::UP, GameMap::Adjacency::TOP_RIGHT, GameMap::Adjacency::BOTTOM_RIGHT,
+        GameMap::Adjacency::DOWN, GameMap::Adjacency::BOTTOM_LEFT, GameMap::Adjacency::TOP_LEFT};
+    const vector<GameMap::Adjacency> directions(ALL_DIRECTIONS.begin(), ALL_DIRECTIONS.end());
+    // Aura de ataque +2 sobre la fuente cuando un enemigo entra junto a ella
+    auto makeEffect = [&](const shared_ptr<Unit>& source) {
+        return make_shared<ComposedEffect>(make_shared<AttackModifierEffectImpl>(source, 0, 2, true),
+                                           TriggerFactory::createOnEnemyEnterTrigger(source, 0, directions),
+                                           TargetSelectorFactory::createSelfSelector(source, 0), source, 0);
+    };
+    auto subscribedCells = [](const EffectStack& stack) {
+        uint64_t cells = 0;
+        for (CellIndex cell = 0; cell < 64; ++cell) {
+            if (stack.getSubscriberCount(TriggerAction::ON_POSITION_ENTER, cell)) cells |= uint64_t{1} << cell;
+        }
+        return cells;
+    };
+
+    GameMap map;
+    CellIndex center = 0;
+    GameMap::forEachCell(map.getEmptyMask(), [&](CellIndex index) {
+        if (popcount(map.getNeighborMask(index) & map.getEmptyMask()) >
+            popcount(map.getNeighborMask(center) & map.getEmptyMask())) center = index;
+    });
+    auto source = make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1);
+    map.placeCard(center, source);
+    auto [centerX, centerY] = map.toCoordinates(center);
+    source->setPosition(centerX, centerY);
+
+    // El efecto se suscribe a las celdas vecinas de su fuente y solo lo
+    // evalúan los eventos en ellas; si no se activa, sigue suscrito
+    EffectStack stack;
+    const EffectPtr effect = makeEffect(source);
+    const uint64_t watched = effect->getWatchedCells(map);
+    stack.addTriggeredEffect(effect, map);
+    const CellIndex neighbor = static_cast<CellIndex>(countr_zero(map.getNeighborMask(center) & map.getEmptyMask()));
+    const CellIndex far = static_cast<CellIndex>(countr_zero(map.getEmptyMask() & ~watched & ~(uint64_t{1} << center)));
+    map.placeCard(far, make_shared<Unit>(1, "Enemigo", 1, "", 1, 1, 5, 1, 1));
+    stack.processPositionEnter(map, map.at(far));
+    bool ok = watched != 0 && (watched >> neighbor & 1) && subscribedCells(stack) == watched &&
+              source->getAttack() == 2;
+    map.moveCard(far, neighbor);
+    stack.processPositionEnter(map, map.at(neighbor));
+    ok = ok && source->getAttack() == 4;
+    stack.processPositionEnter(map, map.at(neighbor));
+    ok = ok && stack.getEffectCount() == 1 && subscribedCells(stack) == watched;
+
+    // Al moverse la fuente se vuelve a suscribir; deshacer restaura las celdas
+    GameJournal journal;
+    stack.setJournal(&journal);
+    const CellIndex destination = static_cast<CellIndex>(countr_zero(map.getEmptyMask() & ~watched & ~(uint64_t{1} << center)));
+    map.moveCard(center, destination);
+    auto [destinationX, destinationY] = map.toCoordinates(destination);
+    source->setPosition(destinationX, destinationY);
+    stack.refreshSubscriptions(source, map);
+    ok = ok && subscribedCells(stack) == effect->getWatchedCells(map) && subscribedCells(stack) != watched;
+    while (!journal.empty()) {
+        stack.undo(journal.back());
+        journal.pop();
+    }
+    stack.setJournal(nullptr);
+    ok = ok && subscribedCells(stack) == watched;
+
+    // Salida: la entrada del enemigo arma el trigger y su salida lo activa
+    GameMap exitMap;
+    auto guard = make_shared<Unit>(0, "Guardia", 1, "", 0, 2, 5, 1, 1);
+    exitMap.placeCard(center, guard);
+    guard->setPosition(centerX, centerY);
+    auto exitEffect = make_shared<ComposedEffect>(make_shared<AttackModifierEffectImpl>(guard, 0, 2, true),
+                                                  TriggerFactory::createOnEnemyExitTrigger(guard, 0, directions),
+                                                  TargetSelectorFactory::createSelfSelector(guard, 0), guard, 0);
+    EffectStack exitStack;
+    exitStack.addTriggeredEffect(exitEffect, exitMap);
+    ok = ok && exitStack.getSubscriberCount(TriggerAction::ON_POSITION_EXIT, neighbor) == 1;
+    exitMap.placeCard(far, make_shared<Unit>(1, "Enemigo", 1, "", 1, 1, 5, 1, 1));
+    exitMap.moveCard(far, neighbor);
+    exitStack.processPositionEnter(exitMap, exitMap.at(neighbor));
+    ok = ok && guard->getAttack() == 2;
+    exitMap.moveCard(neighbor, far);
+    exitStack.processPositionExit(exitMap, exitMap.at(neighbor));
+    ok = ok && guard->getAttack() == 4 && exitStack.getEffectCount() == 1;
+    if (!ok) {
+        println("{}✗ Suscripciones por celda incorrectas{}", RED, RESET);
+        return false;
+    }
+
+    // 256 efectos con fuentes repartidas por el mapa vacío; un evento en cada
+    // celda transitable por turno
+    constexpr size_t EFFECTS = 256;
+    GameMap board;
+    vector<CellIndex> cells;
+    GameMap::forEachCell(board.getEmptyMask(), [&](CellIndex index) { cells.push_back(index); });
+    EffectStack subscribed;
+    vector<EffectPtr> all;
+    for (size_t i = 0; i < EFFECTS; ++i) {
+        auto unit = make_shared<Unit>(static_cast<uint8_t>(i), "Fuente", 1, "", 0, 2, 5, 1, 1);
+        auto [x, y] = board.toCoordinates(cells[i * 7 % cells.size()]);
+        unit->setPosition(x, y);
+        all.push_back(makeEffect(unit));
+        subscribed.addTriggeredEffect(all.back(), board);
+    }
+
+    constexpr size_t ITERATIONS = 20'000;
+    double scan = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        size_t fired = 0;
+        for (size_t i = 0; i < n; ++i) {
+            for (CellIndex cell : cells) {
+                for (const EffectPtr& candidate : all) fired += candidate->shouldTrigger(board, board.at(cell));
+            }
+        }
+        benchSink = fired;
+    });
+
+    double dispatch = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            for (CellIndex cell : cells) subscribed.processPositionEnter(board, board.at(cell));
+        }
+        benchSink = subscribed.getEffectCount();
+    });
+
+    if (subscribed.getEffectCount() != EFFECTS) {
+        println("{}✗ Los eventos sin enemigos retiraron efectos suscritos{}", RED, RESET);
+        return false;
+    }
+
+    printBenchResult("eventos de un turno (evaluar todos los efectos)", scan);
+    printBenchResult("eventos de un turno (suscriptores de la celda)", dispatch);
+    println("  Speedup: {}x", scan / dispatch);
+
+    // Mover una fuente solo vuelve a suscribir sus efectos; el resto de la pila no cambia
+    auto totalSubscriptions = [&] {
+        size_t total = 0;
+        for (CellIndex cell = 0; cell < 64; ++cell) total += subscribed.getSubscriberCount(TriggerAction::ON_POSITION_ENTER, cell);
+        return total;
+    };
+    auto expectedSubscriptions = [&] {
+        size_t total = 0;
+        for (const EffectPtr& candidate : all) total += popcount(candidate->getWatchedCells(board));
+        return total;
+    };
+    const auto moved = static_pointer_cast<Unit>(all.front()->getSource());
+    const uint64_t before = all.front()->getWatchedCells(board);
+    auto [movedX, movedY] = board.toCoordinates(cells[cells.size() / 2]);
+    moved->setPosition(movedX, movedY);
+    subscribed.refreshSubscriptions(moved, board);
+    if (all.front()->getWatchedCells(board) == before || totalSubscriptions() != expectedSubscriptions()) {
+        println("{}✗ refreshSubscriptions no resuscribió la fuente movida{}", RED, RESET);
+        return false;
+    }
+
+    // Buscar los efectos de la fuente recorriendo la pila (como antes) vs el índice por fuente
+    constexpr size_t REFRESHES = 200'000;
+    double linearRefresh = measureNanosPerOp(REFRESHES, [&](size_t n) {
+        size_t found = 0;
+        for (size_t i = 0; i < n; ++i) {
+            for (int bucket = 0; bucket < 2; ++bucket) {
+                for (const EffectPtr& candidate : all) found += candidate->getSource().get() == moved.get();
+            }
+        }
+        benchSink = found;
+    });
+    double indexedRefresh = measureNanosPerOp(REFRESHES, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) subscribed.refreshSubscriptions(moved, board);
+        benchSink = subscribed.getEffectCount();
+    });
+    printBenchResult("refreshSubscriptions (recorrer los cubos de posición)", linearRefresh);
+    printBenchResult("refreshSubscriptions (índice por fuente)", indexedRefresh);
+    println("  Speedup: {}x", linearRefresh / indexedRefresh);
+    return true;
+}
+
+bool benchSingleResolve() {
+    using namespace StrColors;
+    println("{}=== Activación de efectos: una selección de objetivos vs varias ==={}", BOLD, RESET);
+
+    GameMap map;
+    CellIndex center = 0;
+    GameMap::forEachCell(map.getEmptyMask(), [&](CellIndex index) {
+        if (popcount(map.getNeighborMask(index) & map.getEmptyMask()) >
+            popcount(map.getNeighborMask(center) & map.getEmptyMask())) center = index;
+    });
+    auto source = make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1);
+    map.placeCard(center, source);
+    auto [centerX, centerY] = map.toCoordinates(center);
+    source->setPosition(centerX, centerY);
+    GameMap::forEachCell(map.getNeighborMask(center) & map.getEmptyMask(), [&](CellIndex index) {
+        map.placeCard(index, make_shared<Unit>(index, "U", 1, "", 0, 1, 5, 1, 1));
+    });
+
+    // Aura +1 a las unidades adyacentes al final del turno
+    auto effect = make_shared<ComposedEffect>(
+        make_shared<AttackModifierEffectImpl>(source, 0, 1, true), TriggerFactory::createOnEndTurnTrigger(source, 0),
+        TargetSelectorFactory::createAdjacentSelector(source, 0), source, 0);
+    MapCell* trigger = map.at(center);
+
+    // Los dos caminos dejan el mismo tablero (las selecciones las cuenta la prueba de main.cpp)
+    effect->execute(map, trigger);
+    const uint64_t applied = map.getBoardHash();
+    if (effect->checkEffect(map, trigger, {})) effect->apply(map, trigger, {});
+    bool ok = map.getBoardHash() == applied;
+    if (effect->shouldTrigger(map, trigger)) effect->resolve(map, trigger, nullptr, {});
+    ok = ok && map.getBoardHash() == applied && map.getBoardHash() == map.computeBoardHash();
+    if (!ok) {
+        println("{}✗ resolve y checkEffect + apply no dejan el mismo tablero{}", RED, RESET);
+        return false;
+    }
+
+    constexpr size_t ITERATIONS = 500'000;
+    double separate = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (effect->checkEffect(map, trigger, {})) effect->apply(map, trigger, {});
+        }
+        benchSink = source->getAttack();
+    });
+
+    double resolved = measureNanosPerOp(ITERATIONS, [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (effect->shouldTrigger(map, trigger)) effect->resolve(map, trigger, nullptr, {});
+        }
+        benchSink = source->getAttack();
+    });
+
+    printBenchResult("activación (checkEffect + apply)", separate);
+    printBenchResult("activación (resolve)", resolved);
+    println("  Speedup: {}x", separate / resolved);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    using namespace StrColors;
+    println("{}=== SD GAME ENGINE 2XD - MICROBENCHMARKS ==={}", BOLD, RESET);
+
+    bool ok = benchNeighborLookup();
+    ok = benchOccupancyQueries() && ok;
+    ok = benchAttackTargets() && ok;
+    ok = benchReachability() && ok;
+    ok = benchRays() && ok;
+    ok = benchStateHash() && ok;
+    ok = benchStatKernels() && ok;
+    ok = benchCardPrototypes() && ok;
+    ok = benchGameArena() && ok;
+    ok = benchTargetLists() && ok;
+    ok = benchSymbols() && ok;
+    ok = benchGameClone() && ok;
+    ok = benchUndoJournal() && ok;
+    ok = benchStatModifiers() && ok;
+    ok = benchEffectExpiry() && ok;
+    ok = benchEffectHandles() && ok;
+    ok = benchTriggerBuckets() && ok;
+    ok = benchCellSubscriptions() && ok;
+    ok = benchSingleResolve() && ok;
+
+    return ok ? 0 : 1;
+}
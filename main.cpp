@@ -7,10 +7,12 @@
 #include <functional>
 #include <iomanip>
 #include <memory>
+#include <bit>
 #include "src/api/GameAPI.hpp"
 #include "src/config/GameConfig.hpp"
 #include "src/cards/CardLoader.hpp"
 #include "src/game/GameState.hpp"
+#include "src/effects/ComposedEffectFactory.hpp"
 #include "src/utils/StrColors.hpp"
 
 using namespace std;
@@ -99,6 +101,9 @@ bool testMovementAndCombat(GameAPI& api, const GameConfig& config);
 bool testEffectSystem(GameAPI& api, const GameConfig& config);
 bool testGameFlow(GameAPI& api, const GameConfig& config);
 bool testAISimulation(GameAPI& api, const GameConfig& config);
+bool testEffectDuration(GameAPI& api, const GameConfig& config);
+bool testSingleTargetSelection(GameAPI& api, const GameConfig& config);
+bool testPositionTriggers(GameAPI& api, const GameConfig& config);
 
 // Funciones auxiliares
 void printTestHeader(const string& testName);
@@ -135,7 +140,10 @@ int main() {
         TestCase("Movimiento y Combate", testMovementAndCombat),
         TestCase("Sistema de Efectos", testEffectSystem),
         TestCase("Flujo de Juego Completo", testGameFlow),
-        TestCase("Simulación de IA", testAISimulation)
+        TestCase("Simulación de IA", testAISimulation),
+        TestCase("Duración de Efectos", testEffectDuration),
+        TestCase("Una Selección de Objetivos por Activación", testSingleTargetSelection),
+        TestCase("Efectos de Entrada en Partida", testPositionTriggers)
     };
     
     // Ejecutar todas las pruebas
@@ -425,12 +433,15 @@ bool testMovementAndCombat(GameAPI& api, const GameConfig& config) {
     uint8_t sourceX = 0, sourceY = 0;
     bool cardFound = false;
     
+    // Preferir una carta que pueda moverse (el movimiento depende de su velocidad y del camino libre)
     for (const auto& cell : gameInfo.mapCells) {
         if (cell.hasCard && cell.cardOwner == currentPlayer) {
-            sourceX = cell.x;
-            sourceY = cell.y;
+            if (!cardFound || (api.getValidMovePositions(sourceX, sourceY).empty() &&
+                               !api.getValidMovePositions(cell.x, cell.y).empty())) {
+                sourceX = cell.x;
+                sourceY = cell.y;
+            }
             cardFound = true;
-            break;
         }
     }
     
@@ -518,10 +529,17 @@ bool testGameFlow(GameAPI& api, const GameConfig& config) {
     auto gameInfo = api.getGameInfo();
     int initialTurn = gameInfo.turn;
     PlayerId initialPlayer = gameInfo.currentPlayer;
+    uint64_t initialHash = api.getStateHash();
     
     // Terminar turno actual
     api.endTurn();
     
+    // El hash del estado debe reflejar el cambio de turno
+    if (api.getStateHash() == initialHash) {
+        println("{}✗ El hash del estado no cambió tras terminar el turno{}", RED, RESET);
+        return false;
+    }
+    
     auto newGameInfo = api.getGameInfo();
     
     // Verificar que el turno cambió correctamente
@@ -547,6 +565,239 @@ bool testGameFlow(GameAPI& api, const GameConfig& config) {
     return true;
 }
 
+bool testEffectDuration(GameAPI& api, const GameConfig& config) {
+    (void)api; // Usa su propia partida para controlar los mazos
+    using namespace StrColors;
+    
+    println("{}Probando la duración de efectos por turno de jugador...{}", CYAN, RESET);
+    
+    // Mazo de una leyenda y hechizos de coste 0 con un efecto inocuo
+    auto buildDeck = [](PlayerId playerId) {
+        vector<CardPtr> deck;
+        deck.push_back(make_shared<Legend>(100 + playerId, "Leyenda", 0, "", playerId, 1, 20, 1, 1));
+        for (uint16_t id = 0; id < 12; ++id) {
+            auto spell = make_shared<Spell>(200 + playerId * 20 + id, "Hechizo", 0, "", playerId);
+            spell->addEffect(make_shared<ComposedEffect>(
+                make_shared<PrintEffectImpl>(spell, playerId, "duración"),
+                make_shared<OnPlayTrigger>(spell, playerId),
+                make_shared<SelfTargetSelector>(spell, playerId), spell, playerId));
+            deck.push_back(spell);
+        }
+        return deck;
+    };
+    
+    // Un efecto de duración N sale del stack al terminar el N-ésimo turno
+    // siguiente al del lanzador (0 = al final del propio turno), sea cual
+    // sea el asiento: se cuentan turnos de jugador, no rondas
+    bool allPassed = true;
+    for (PlayerId seat = 0; seat < 2; ++seat) {
+        for (int duration = 0; duration <= 2; ++duration) {
+            // El constructor ya coloca las leyendas y reparte la mano inicial
+            GameState game(buildDeck(0), buildDeck(1), config);
+            if (seat == 1) game.endTurn(0);
+            
+            const auto& hand = game.getPlayer(seat).hand;
+            if (hand.empty()) {
+                println("{}✗ Jugador {} sin cartas en mano{}", RED, seat, RESET);
+                return false;
+            }
+            CardPtr spell = hand.front();
+            spell->getEffects().front()->setDuration(duration);
+            game.playCard(seat, spell, 0, 0);
+            if (game.getEffectStack().getEffectCount() != 1) {
+                println("{}✗ El hechizo del jugador {} no dejó su efecto en el stack{}", RED, seat, RESET);
+                return false;
+            }
+            
+            int turnsEnded = 0;
+            while (game.getEffectStack().getEffectCount() > 0 && turnsEnded <= duration + 2) {
+                game.endTurn(game.getCurrentPlayer());
+                ++turnsEnded;
+            }
+            
+            if (turnsEnded == duration + 1) {
+                println("{}✓ Jugador {}, duración {}: expira tras {} turno(s){}", GREEN, seat, duration, turnsEnded, RESET);
+            } else {
+                println("{}✗ Jugador {}, duración {}: expira tras {} turno(s), se esperaban {}{}",
+                        RED, seat, duration, turnsEnded, duration + 1, RESET);
+                allPassed = false;
+            }
+        }
+    }
+    
+    return allPassed;
+}
+
+// Selector de prueba: delega en otro y cuenta cuántas veces se seleccionan
+// objetivos, para comprobar que cada activación selecciona una sola vez
+class CountingTargetSelector : public TargetSelector {
+private:
+    TargetSelectorPtr inner;
+    size_t selections = 0;
+
+public:
+    explicit CountingTargetSelector(TargetSelectorPtr selector)
+        : TargetSelector(nullptr, 0, selector->getSymbol()), inner(std::move(selector)) {}
+    
+    CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
+        ++selections;
+        return inner->selectTargets(gameMap, triggerCell);
+    }
+    
+    bool isValidTarget(const GameMap& gameMap, MapCell* cell) const override {
+        return inner->isValidTarget(gameMap, cell);
+    }
+    
+    size_t getSelections() const { return selections; }
+    void resetSelections() { selections = 0; }
+    
+    TargetSelectorPtr clone(CloneContext& context) const override {
+        auto copy = GameArena::makeShared<CountingTargetSelector>(*this);
+        copy->inner = inner->clone(context);
+        return copy;
+    }
+};
+
+bool testSingleTargetSelection(GameAPI& api, const GameConfig& config) {
+    (void)api; (void)config; // Usa su propio mapa
+    using namespace StrColors;
+    
+    println("{}Probando que cada activación selecciona sus objetivos una vez...{}", CYAN, RESET);
+    
+    // Fuente en la celda con más vecinas libres, rodeada de unidades propias
+    GameMap map;
+    CellIndex center = 0;
+    GameMap::forEachCell(map.getEmptyMask(), [&](CellIndex index) {
+        if (popcount(map.getNeighborMask(index) & map.getEmptyMask()) >
+            popcount(map.getNeighborMask(center) & map.getEmptyMask())) center = index;
+    });
+    auto source = make_shared<Unit>(0, "Fuente", 1, "", 0, 2, 5, 1, 1);
+    map.placeCard(center, source);
+    auto [centerX, centerY] = map.toCoordinates(center);
+    source->setPosition(centerX, centerY);
+    GameMap::forEachCell(map.getNeighborMask(center) & map.getEmptyMask(), [&](CellIndex index) {
+        auto unit = make_shared<Unit>(index, "Vecina", 1, "", 0, 1, 5, 1, 1);
+        map.placeCard(index, unit);
+        auto [x, y] = map.toCoordinates(index);
+        unit->setPosition(x, y);
+    });
+    
+    // Aura +1 a las unidades adyacentes al final del turno
+    auto selector = make_shared<CountingTargetSelector>(TargetSelectorFactory::createAdjacentSelector(source, 0));
+    auto effect = make_shared<ComposedEffect>(
+        make_shared<AttackModifierEffectImpl>(source, 0, 1, true), TriggerFactory::createOnEndTurnTrigger(source, 0),
+        selector, source, 0);
+    MapCell* trigger = map.at(center);
+    
+    bool allPassed = true;
+    auto expect = [&](const string& path, auto activate, size_t expected) {
+        selector->resetSelections();
+        activate();
+        const bool passed = selector->getSelections() == expected && map.getBoardHash() == map.computeBoardHash();
+        if (passed) {
+            println("{}✓ {}: {} selección(es){}", GREEN, path, selector->getSelections(), RESET);
+        } else {
+            println("{}✗ {}: {} selección(es), se esperaban {}{}", RED, path, selector->getSelections(), expected, RESET);
+            allPassed = false;
+        }
+    };
+    
+    expect("execute", [&] { effect->execute(map, trigger); }, 1);
+    EffectStack stack;
+    stack.addTriggeredEffect(effect, map);
+    expect("EffectStack::processEndOfTurn", [&] { stack.processEndOfTurn(map); }, 1);
+    expect("shouldTrigger + resolve", [&] {
+        if (effect->shouldTrigger(map, trigger)) effect->resolve(map, trigger, nullptr, {});
+    }, 1);
+    // Por partes, con la misma lista para comprobar y aplicar
+    expect("selectTargets + isApplicable + applyTo", [&] {
+        const CellList targets = effect->selectTargets(map, trigger);
+        if (effect->isApplicable(map, trigger, targets)) effect->applyTo(map, trigger, targets);
+    }, 1);
+    expect("apply (legacy)", [&] { effect->apply(map, trigger, {}); }, 1);
+    // El par legacy no comparte estado: apply vuelve a seleccionar y comprobar
+    expect("checkEffect + apply (legacy)", [&] {
+        if (effect->checkEffect(map, trigger, {})) effect->apply(map, trigger, {});
+    }, 2);
+    
+    return allPassed;
+}
+
+bool testPositionTriggers(GameAPI& api, const GameConfig& config) {
+    (void)api; // Usa su propia partida para controlar los mazos
+    using namespace StrColors;
+    
+    println("{}Probando efectos de entrada de enemigos a través de GameState...{}", CYAN, RESET);
+    
+    // Jugador 0: unidades vigía con +2 de ataque cuando un enemigo entra junto a
+    // ellas. Jugador 1: unidades rápidas que pueden cruzar el tablero
+    const vector<GameMap::Adjacency> allDirections = {
+        GameMap::Adjacency::UP, GameMap::Adjacency::TOP_RIGHT, GameMap::Adjacency::BOTTOM_RIGHT,
+        GameMap::Adjacency::DOWN, GameMap::Adjacency::BOTTOM_LEFT, GameMap::Adjacency::TOP_LEFT
+    };
+    auto buildDeck = [&](PlayerId playerId) {
+        vector<CardPtr> deck;
+        deck.push_back(make_shared<Legend>(100 + playerId, "Leyenda", 0, "", playerId, 1, 20, 1, 1));
+        for (uint16_t id = 0; id < 12; ++id) {
+            auto unit = make_shared<Unit>(200 + playerId * 20 + id, playerId == 0 ? "Vigía" : "Corredor", 0, "",
+                                          playerId, 1, 5, playerId == 0 ? 1 : 6, 1);
+            if (playerId == 0) {
+                unit->addEffect(make_shared<ComposedEffect>(
+                    make_shared<AttackModifierEffectImpl>(unit, playerId, 2),
+                    TriggerFactory::createOnEnemyEnterTrigger(unit, playerId, allDirections),
+                    make_shared<SelfTargetSelector>(unit, playerId), unit, playerId));
+            }
+            deck.push_back(unit);
+        }
+        return deck;
+    };
+    
+    // Leyendas en (2, 0) y (2, 6): la vigía junto a la suya, el corredor junto a la otra
+    GameState game(buildDeck(0), buildDeck(1), config);
+    const CardPtr watcher = game.getPlayer(0).hand.front();
+    game.playCard(0, watcher, 2, 1);
+    game.endTurn(0);
+    const CardPtr runner = game.getPlayer(1).hand.front();
+    game.playCard(1, runner, 2, 5);
+    const Unit* watcherUnit = Card::as<Unit>(watcher);
+    if (!watcherUnit || !game.getCardPosition(runner) || watcherUnit->getAttack() != 1 ||
+        game.getEffectStack().getSubscriberCount(TriggerAction::ON_POSITION_ENTER, game.getMap().toIndex(2, 2)) != 1) {
+        println("{}✗ No se pudo preparar la partida (vigía en (2, 1) suscrita a (2, 2)){}", RED, RESET);
+        return false;
+    }
+    
+    bool allPassed = true;
+    auto expect = [&](const string& step, int attack) {
+        if (watcherUnit->getAttack() == attack) {
+            println("{}✓ {}: ataque {}{}", GREEN, step, attack, RESET);
+        } else {
+            println("{}✗ {}: ataque {}, se esperaba {}{}", RED, step, watcherUnit->getAttack(), attack, RESET);
+            allPassed = false;
+        }
+    };
+    
+    // Entrar en una celda vigilada activa el efecto una vez; salir la rearma
+    game.moveCard(1, runner, 2, 2);
+    expect("el enemigo entra junto a la vigía", 3);
+    game.moveCard(1, runner, 2, 3);
+    expect("el enemigo se aleja", 3);
+    game.moveCard(1, runner, 2, 2);
+    expect("el enemigo vuelve a entrar", 5);
+    
+    // Deshacer la entrada devuelve el ataque y el estado del trigger
+    game.enableJournal();
+    game.moveCard(1, runner, 2, 3);
+    game.moveCard(1, runner, 2, 2);
+    expect("sale y entra de nuevo", 7);
+    game.undo(2);
+    expect("tras deshacer las dos jugadas", 5);
+    game.moveCard(1, runner, 2, 3);
+    game.moveCard(1, runner, 2, 2);
+    expect("se repiten tras deshacer", 7);
+    
+    return allPassed;
+}
+
 bool testAISimulation(GameAPI& api, const GameConfig& config) {
     (void)config; // Suppress unused parameter warning
     using namespace StrColors;
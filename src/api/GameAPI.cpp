@@ -1,6 +1,7 @@
 #include "GameAPI.hpp"
 #include "../cards/Card.hpp" // Para acceder a Legend
 #include <algorithm>
+#include <bit>
 #include <iostream>
 
 GameAPI::GameAPI() : gameState(nullptr), initialized(false) {}
@@ -10,7 +11,9 @@ bool GameAPI::initializeGame(const std::string& deckFilePath,
                            const std::string& player1Name) {
     try {
         // Cargar mazos desde archivo JSON
-        std::vector<CardLoader::DeckConfig> deckConfigs = CardLoader::loadDecksFromFile(deckFilePath);
+        // Catálogo compartido: el archivo solo se parsea la primera vez
+        const auto catalog = CardLoader::loadCatalog(deckFilePath);
+        const std::vector<CardLoader::DeckConfig>& deckConfigs = *catalog;
         
         if (deckConfigs.size() < 2) {
             return false; // Necesitamos al menos 2 mazos
@@ -58,18 +61,19 @@ bool GameAPI::initializeGameWithConfig(const std::string& deckFilePath,
                                      const GameConfig& config) {
     try {
         // Cargar mazos desde archivo JSON
-        std::vector<CardLoader::DeckConfig> deckConfigs = CardLoader::loadDecksFromFile(deckFilePath);
+        // Catálogo compartido: el archivo solo se parsea la primera vez
+        const auto catalog = CardLoader::loadCatalog(deckFilePath);
+        const std::vector<CardLoader::DeckConfig>& deckConfigs = *catalog;
         
         if (deckConfigs.size() < 2) {
             return false; // Necesitamos al menos 2 mazos
         }
 
-        // Crear cartas para cada jugador
-        std::vector<CardPtr> deck0 = CardLoader::createCardsFromConfig(deckConfigs[0], 0);
-        std::vector<CardPtr> deck1 = CardLoader::createCardsFromConfig(deckConfigs[1], 1);
-
-        // Crear nuevo estado de juego con configuración
-        gameState = std::make_unique<GameState>(std::move(deck0), std::move(deck1), config);
+        // Crear nuevo estado de juego con configuración; las cartas de cada
+        // jugador se crean dentro de la arena de la partida
+        gameState = std::make_unique<GameState>([&](PlayerId playerId) {
+            return CardLoader::createCardsFromConfig(deckConfigs[playerId], playerId);
+        }, config);
         
         initialized = true;
         return true;
@@ -95,8 +99,10 @@ GameAPI::GameInfo GameAPI::getGameInfo() const {
     info.mapVisualization = getMapVisualization();
     
     // Llenar información de celdas del mapa
-    for (uint8_t y = 0; y < GameMap::MAP_HEIGHT; ++y) {
-        for (uint8_t x = 0; x < GameMap::MAP_WIDTH; ++x) {
+    const GameMap& map = gameState->getMap();
+    info.mapCells.reserve(map.getCellCount());
+    for (uint8_t y = 0; y < map.getHeight(); ++y) {
+        for (uint8_t x = 0; x < map.getWidth(); ++x) {
             info.mapCells.push_back(extractCellInfo(x, y));
         }
     }
@@ -114,7 +120,7 @@ GameAPI::PlayerInfo GameAPI::getPlayerInfo(PlayerId playerId) const {
 }
 
 std::optional<GameAPI::CellInfo> GameAPI::getCellInfo(uint8_t x, uint8_t y) const {
-    if (!isInitialized() || x >= GameMap::MAP_WIDTH || y >= GameMap::MAP_HEIGHT) {
+    if (!isInitialized() || !gameState->getMap().at(x, y)) {
         return std::nullopt;
     }
     
@@ -129,6 +135,14 @@ std::string GameAPI::getMapVisualization() const {
     return std::string(gameState->getMap());
 }
 
+uint64_t GameAPI::getStateHash() const {
+    if (!isInitialized()) {
+        return 0;
+    }
+    
+    return gameState->getStateHash();
+}
+
 bool GameAPI::isGameOver() const {
     if (!isInitialized()) {
         return true;
@@ -182,13 +196,12 @@ GameAPI::ActionResult GameAPI::playCard(PlayerId playerId, size_t cardIndex, uin
     }
     
     // Verificar que la carta no es una leyenda - las leyendas no se pueden jugar desde la mano
-    if (auto legend = std::dynamic_pointer_cast<Legend>(card)) {
+    if (card->isLegend()) {
         return ActionResult::INVALID_CARD; // Las leyendas no se pueden jugar desde la mano
     }
     
     // Verificar que la carta es una unidad (no se pueden jugar hechizos directamente en el mapa)
-    auto unit = std::dynamic_pointer_cast<Unit>(card);
-    if (!unit) {
+    if (!card->isUnit()) {
         return ActionResult::INVALID_CARD; // Solo se pueden jugar unidades en el mapa
     }
     
@@ -235,11 +248,11 @@ GameAPI::ActionResult GameAPI::moveCard(PlayerId playerId, uint8_t fromX, uint8_
     
     // Verificar que hay una carta en la posición origen
     MapCell* fromCell = gameState->getMap().at(fromX, fromY);
-    if (!fromCell || !fromCell->card.has_value()) {
+    if (!fromCell || !fromCell->hasCard()) {
         return ActionResult::INVALID_CARD;
     }
     
-    CardPtr card = fromCell->card.value();
+    CardPtr card = gameState->getMap().getCard(fromCell);
     if (card->getOwner() != playerId) {
         return ActionResult::INVALID_CARD;
     }
@@ -282,11 +295,11 @@ GameAPI::ActionResult GameAPI::attackCard(PlayerId playerId, uint8_t fromX, uint
     
     // Verificar que hay una carta en la posición origen
     MapCell* fromCell = gameState->getMap().at(fromX, fromY);
-    if (!fromCell || !fromCell->card.has_value()) {
+    if (!fromCell || !fromCell->hasCard()) {
         return ActionResult::INVALID_CARD;
     }
     
-    CardPtr card = fromCell->card.value();
+    CardPtr card = gameState->getMap().getCard(fromCell);
     if (card->getOwner() != playerId) {
         return ActionResult::INVALID_CARD;
     }
@@ -372,8 +385,7 @@ GameAPI::ActionResult GameAPI::castSpell(PlayerId playerId, size_t cardIndex) {
     CardPtr card = player.hand[cardIndex];
     
     // Verificar que la carta es un hechizo
-    auto spell = std::dynamic_pointer_cast<Spell>(card);
-    if (!spell) {
+    if (!card || !card->isSpell()) {
         return ActionResult::INVALID_CARD; // Solo se pueden lanzar hechizos
     }
     
@@ -411,14 +423,18 @@ std::vector<std::pair<uint8_t, uint8_t>> GameAPI::getValidPlayPositions(PlayerId
         return positions;
     }
     
-    for (uint8_t y = 0; y < GameMap::MAP_HEIGHT; ++y) {
-        for (uint8_t x = 0; x < GameMap::MAP_WIDTH; ++x) {
-            if (isValidPlayPosition(playerId, x, y)) {
-                positions.emplace_back(x, y);
-            }
-        }
+    if (playerId > 1) {
+        return positions;
     }
     
+    // Candidatas = vacías & adyacentes a la leyenda & territorio del jugador
+    const GameMap& map = gameState->getMap();
+    const uint64_t candidates = map.getPlacementMask(playerId) & map.getTerritoryMask(playerId);
+    positions.reserve(std::popcount(candidates));
+    GameMap::forEachCell(candidates, [&](CellIndex index) {
+        positions.push_back(map.toCoordinates(index));
+    });
+    
     return positions;
 }
 
@@ -430,24 +446,23 @@ std::vector<std::pair<uint8_t, uint8_t>> GameAPI::getValidMovePositions(uint8_t
     }
     
     MapCell* fromCell = gameState->getMap().at(x, y);
-    if (!fromCell || !fromCell->card.has_value()) {
+    if (!fromCell || !fromCell->hasCard()) {
         return positions;
     }
     
-    CardPtr card = fromCell->card.value();
-    auto unit = std::dynamic_pointer_cast<Unit>(card);
+    CardPtr card = gameState->getMap().getCard(fromCell);
+    const Unit* unit = Card::as<Unit>(card);
     if (!unit) {
         return positions;
     }
     
-    // Para simplificar, asumimos que se puede mover a celdas adyacentes caminables y vacías
-    for (uint8_t toY = 0; toY < GameMap::MAP_HEIGHT; ++toY) {
-        for (uint8_t toX = 0; toX < GameMap::MAP_WIDTH; ++toX) {
-            if (gameState->canMoveCard(card->getOwner(), card, x, y, toX, toY)) {
-                positions.emplace_back(toX, toY);
-            }
-        }
-    }
+    // Conjunto alcanzable según la velocidad de la unidad (cacheado en GameState)
+    const GameMap& map = gameState->getMap();
+    const uint64_t reachable = gameState->getReachableMask(card);
+    positions.reserve(std::popcount(reachable));
+    GameMap::forEachCell(reachable, [&](CellIndex index) {
+        positions.push_back(map.toCoordinates(index));
+    });
     
     return positions;
 }
@@ -460,87 +475,42 @@ std::vector<std::pair<uint8_t, uint8_t>> GameAPI::getValidAttackPositions(uint8_
     }
     
     MapCell* fromCell = gameState->getMap().at(x, y);
-    if (!fromCell || !fromCell->card.has_value()) {
+    if (!fromCell || !fromCell->hasCard()) {
         return positions;
     }
     
-    CardPtr card = fromCell->card.value();
-    auto unit = std::dynamic_pointer_cast<Unit>(card);
+    CardPtr card = gameState->getMap().getCard(fromCell);
+    const Unit* unit = Card::as<Unit>(card);
     if (!unit) {
         return positions;
     }
     
-    // Verificar todas las posiciones dentro del rango de ataque
-    for (uint8_t toY = 0; toY < GameMap::MAP_HEIGHT; ++toY) {
-        for (uint8_t toX = 0; toX < GameMap::MAP_WIDTH; ++toX) {
-            if (gameState->canAttack(card->getOwner(), card, toX, toY)) {
-                positions.emplace_back(toX, toY);
-            }
-        }
-    }
+    // Enemigos dentro del rango de ataque en una sola pasada sobre la máscara
+    const GameMap& map = gameState->getMap();
+    const uint64_t targets = map.getAttackMask(map.toIndex(x, y), unit->getRange(), card->getOwner());
+    positions.reserve(std::popcount(targets));
+    GameMap::forEachCell(targets, [&](CellIndex index) {
+        positions.push_back(map.toCoordinates(index));
+    });
     
     return positions;
 }
 
 bool GameAPI::isValidPlayPosition(PlayerId playerId, uint8_t x, uint8_t y) const {
-    if (!isInitialized()) {
-        return false;
-    }
-    
-    // Verificar que la posición está dentro del mapa
-    if (x >= GameMap::MAP_WIDTH || y >= GameMap::MAP_HEIGHT) {
-        return false;
-    }
-    
-    MapCell* cell = gameState->getMap().at(x, y);
-    if (!cell) {
-        return false;
-    }
-    
-    // La celda debe ser caminable y estar vacía
-    if ((cell->floor == MapCell::FloorType::NONE) || cell->card.has_value()) {
-        return false;
-    }
-    
-    // Verificar que está dentro del territorio del jugador (simplificado)
-    // El jugador 0 puede jugar en las primeras 4 filas, el jugador 1 en las últimas 4
-    if (playerId == 0 && y > 3) {
-        return false;
-    }
-    if (playerId == 1 && y < 3) {
-        return false;
-    }
-    
-    // Verificar que la posición es adyacente al líder del equipo
-    const Player& player = gameState->getPlayer(playerId);
-    if (!player.legend || !player.legend->isOnMap()) {
-        return false; // No se puede jugar sin líder en el mapa
-    }
-    
-    auto legend = std::dynamic_pointer_cast<Unit>(player.legend);
-    if (!legend) {
+    if (!isInitialized() || playerId > 1) {
         return false;
     }
     
-    auto [leaderX, leaderY] = legend->getCoordinates();
-    
-    // Verificar si la posición (x, y) es adyacente al líder
-    // Usamos el sistema de adyacencia hexagonal del GameMap
-    MapCell* leaderCell = gameState->getMap().at(leaderX, leaderY);
-    if (!leaderCell) {
+    // La celda debe existir, ser caminable, estar vacía, ser adyacente al líder
+    // del jugador y estar dentro de su mitad del mapa (la fila central es compartida)
+    const GameMap& map = gameState->getMap();
+    const CellIndex index = map.toIndex(x, y);
+    if (index == NO_CELL) {
         return false;
     }
     
-    // Verificar todas las direcciones de adyacencia
-    for (int i = 0; i < 6; ++i) {
-        GameMap::Adjacency adj = static_cast<GameMap::Adjacency>(i);
-        MapCell* adjacentCell = gameState->getMap().getNeighbor(adj, leaderCell, playerId);
-        if (adjacentCell && adjacentCell == cell) {
-            return true; // La posición es adyacente al líder
-        }
-    }
-    
-    return false; // La posición no es adyacente al líder
+    const uint64_t candidates = map.getPlacementMask(playerId) & map.getTerritoryMask(playerId);
+    return (candidates >> index) & 1u;
 }
 
 std::string GameAPI::actionResultToString(ActionResult result) {
@@ -584,8 +554,8 @@ GameAPI::PlayerInfo GameAPI::extractPlayerInfo(const Player& player) const {
     info.hasLegend = (player.legend != nullptr);
     if (info.hasLegend) {
         info.legendName = player.legend->getName();
-        auto legend = std::dynamic_pointer_cast<Unit>(player.legend);
-        if (legend && legend->isOnMap()) {
+        if (player.legend->isOnMap()) {
+            const Legend* legend = player.legend.get();
             auto coords = legend->getCoordinates();
             info.legendPosition = {coords.first, coords.second};
         } else {
@@ -611,18 +581,18 @@ GameAPI::CellInfo GameAPI::extractCellInfo(uint8_t x, uint8_t y) const {
     
     info.isWalkable = (cell->floor != MapCell::FloorType::NONE);
     info.isSpawn = cell->isSpawn();
-    info.hasCard = cell->card.has_value();
+    info.hasCard = cell->hasCard();
     
     if (info.hasCard) {
-        CardPtr card = cell->card.value();
+        CardPtr card = gameState->getMap().getCard(cell);
         info.cardName = card->getName();
         
-        // Determinar el tipo de carta usando dynamic_pointer_cast
-        if (std::dynamic_pointer_cast<Legend>(card)) {
+        // Determinar el tipo de carta por su etiqueta
+        if (card->isLegend()) {
             info.cardType = "Legend";
-        } else if (std::dynamic_pointer_cast<Unit>(card)) {
+        } else if (card->isUnit()) {
             info.cardType = "Unit";
-        } else if (std::dynamic_pointer_cast<Spell>(card)) {
+        } else if (card->isSpell()) {
             info.cardType = "Spell";
         } else {
             info.cardType = "Unknown";
@@ -630,7 +600,7 @@ GameAPI::CellInfo GameAPI::extractCellInfo(uint8_t x, uint8_t y) const {
         
         info.cardOwner = card->getOwner();
         
-        if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+        if (const Unit* unit = Card::as<Unit>(card)) {
             info.attack = unit->getAttack();
             info.health = unit->getHealth();
             info.speed = unit->getSpeed();
@@ -142,6 +142,13 @@ public:
      */
     std::string getMapVisualization() const;
 
+    /**
+     * Obtiene el hash Zobrist de 64 bits del estado actual (0 si no hay partida).
+     * Dos estados con el mismo tablero, estadísticas, manos, jugador actual,
+     * acciones y turno producen el mismo hash (tablas de transposición, duplicados)
+     */
+    uint64_t getStateHash() const;
+
     /**
      * Verifica si el juego ha terminado
      */
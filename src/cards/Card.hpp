@@ -1,48 +1,111 @@
 #pragma once
 #include <string>
-#include <list>
 #include <memory>
 #include <cstdint>
+#include <algorithm>
 #include "../utils/Types.hpp"
+#include "CardPrototype.hpp"
+#include "../game/UnitStatStore.hpp"
+#include "../utils/GameArena.hpp"
 
 // Forward declaration
 class MapCell;
+class CloneContext;
 
 class Card {
+public:
+    // Etiqueta compacta: tipo concreto en los bits bajos y estado en los altos.
+    // Sustituye a dynamic_pointer_cast en los caminos calientes (ver as<T>())
+    enum Flags : uint8_t {
+        UNIT   = 1 << 0,
+        LEGEND = 1 << 1,  // Siempre junto a UNIT
+        SPELL  = 1 << 2,
+        ON_MAP = 1 << 4   // Colocada en el mapa (estadísticas en el UnitStatStore)
+    };
+
 protected:
-    uint8_t id;
-    std::string name;
+    // Datos inmutables compartidos (id, textos, estadísticas base)
+    CardPrototypePtr prototype;
+    uint8_t flags = 0;
     uint8_t cost;
-    std::string description;
     PlayerId owner;
-    std::string imageLink;
-    std::list<EffectPtr> effects;
+    // Una carta tiene pocos efectos: se guardan inline
+    static constexpr size_t INLINE_EFFECTS = 4;
+    SmallVector<EffectPtr, INLINE_EFFECTS> effects;
+
+    // Prototipo propio para cartas creadas fuera de un catálogo
+    static CardPrototypePtr makePrototype(uint8_t cardId, const std::string& cardName, uint8_t cardCost,
+                                          const std::string& desc, const std::string& image) {
+        auto created = std::make_shared<CardPrototype>();
+        created->id = cardId;
+        created->cost = cardCost;
+        created->name = Symbol(cardName);
+        created->description = desc;
+        created->imageLink = image;
+        return created;
+    }
+
+    // Solo para clone(): mismo prototipo y efectos (CloneContext los remapea),
+    // sin las marcas de estado de la original
+    Card(const Card& other)
+        : prototype(other.prototype), flags(other.flags & ~ON_MAP),
+          cost(other.cost), owner(other.owner), effects(other.effects) {}
+    Card& operator=(const Card&) = delete;
+
+    friend class CloneContext;
 
 public:
+    // Instancia de un prototipo del catálogo
+    Card(CardPrototypePtr cardPrototype, PlayerId ownerId)
+        : prototype(std::move(cardPrototype)), flags(prototype->kind), 
+          cost(prototype->cost), owner(ownerId) {}
+
     Card(uint8_t cardId, const std::string& cardName, uint8_t cardCost, 
          const std::string& desc, PlayerId ownerId, const std::string& image = "")
-        : id(cardId), name(cardName), cost(cardCost), description(desc), 
-          owner(ownerId), imageLink(image) {}
+        : Card(makePrototype(cardId, cardName, cardCost, desc, image), ownerId) {}
 
     virtual ~Card() = default;
 
     // Getters
-    uint8_t getId() const { return id; }
-    const std::string& getName() const { return name; }
+    uint8_t getId() const { return prototype->id; }
+    const std::string& getName() const { return prototype->name.str(); }
     uint8_t getCost() const { return cost; }
-    const std::string& getDescription() const { return description; }
+    const std::string& getDescription() const { return prototype->description; }
     PlayerId getOwner() const { return owner; }
-    const std::string& getImageLink() const { return imageLink; }
-    const std::list<EffectPtr>& getEffects() const { return effects; }
+    const std::string& getImageLink() const { return prototype->imageLink; }
+    const CardPrototype& getPrototype() const { return *prototype; }
+    const SmallVector<EffectPtr, INLINE_EFFECTS>& getEffects() const { return effects; }
+    uint8_t getFlags() const { return flags; }
+    bool hasFlags(uint8_t mask) const { return (flags & mask) == mask; }
+    bool isUnit() const { return flags & UNIT; }
+    bool isLegend() const { return flags & LEGEND; }
+    bool isSpell() const { return flags & SPELL; }
+
+    // Accesos con comprobación de etiqueta: nullptr si la carta no es del tipo
+    // pedido. No tocan el contador de referencias ni recorren RTTI
+    template<typename T>
+    static T* as(Card* card) { return card && card->hasFlags(T::KIND) ? static_cast<T*>(card) : nullptr; }
+    template<typename T>
+    static const T* as(const Card* card) { return card && card->hasFlags(T::KIND) ? static_cast<const T*>(card) : nullptr; }
+    template<typename T>
+    static T* as(const CardPtr& card) { return as<T>(card.get()); }
 
     // Setters
     void setOwner(PlayerId newOwner) { owner = newOwner; }
     void setCost(uint8_t newCost) { cost = newCost; }
     void addEffect(EffectPtr effect) { effects.push_back(effect); }
-    void removeEffect(EffectPtr effect) { effects.remove(effect); }
+    void removeEffect(EffectPtr effect) {
+        auto it = std::find(effects.begin(), effects.end(), effect);
+        if (it != effects.end()) effects.erase(it);
+    }
+    // Rompe el ciclo carta -> efecto -> carta al desmontar la partida
+    void clearEffects() { effects.clear(); }
 
     // Conversion to uint8_t for compatibility
-    operator uint8_t() const { return id; }
+    operator uint8_t() const { return getId(); }
+
+    // Copia en la arena activa; usar CloneContext::card para remapear los efectos
+    virtual CardPtr clone() const = 0;
 
     // Virtual format method
     virtual std::string format() const = 0;
@@ -52,6 +115,9 @@ public:
 };
 
 class Unit : public Card {
+public:
+    static constexpr uint8_t KIND = UNIT;
+
 protected:
     uint8_t attack;
     uint8_t health;
@@ -62,29 +128,83 @@ protected:
     // Position tracking - (255,255) if not on map
     uint8_t x = 255, y = 255;
 
+    // Mientras está en el mapa, las estadísticas viven en el almacén de la partida
+    UnitStatStore* statStore = nullptr;
+    EntityId statEntity = NO_ENTITY;
+
+    // Valor efectivo (con los modificadores del mapa) y valor base
+    uint8_t stat(uint8_t local, UnitStatStore::Column column) const {
+        return statStore ? statStore->get(column, statEntity) : local;
+    }
+    uint8_t baseStat(uint8_t local, UnitStatStore::Column column) const {
+        return statStore ? statStore->base(column, statEntity) : local;
+    }
+    // En el mapa la escritura pasa por el almacén, que la registra para deshacer
+    void writeStat(uint8_t& local, UnitStatStore::Column column, uint8_t value) {
+        if (statStore) statStore->write(column, statEntity, value);
+        else local = value;
+    }
+
 public:
     Unit(uint8_t cardId, const std::string& cardName, uint8_t cardCost, 
          const std::string& desc, PlayerId ownerId, uint8_t atk, uint8_t hp, 
          uint8_t spd, uint8_t rng, const std::string& image = "")
         : Card(cardId, cardName, cardCost, desc, ownerId, image), 
-          attack(atk), health(hp), maxHealth(hp), speed(spd), range(rng) {}
+          attack(atk), health(hp), maxHealth(hp), speed(spd), range(rng) { flags |= UNIT; }
+
+    Unit(CardPrototypePtr cardPrototype, PlayerId ownerId)
+        : Card(std::move(cardPrototype), ownerId), attack(prototype->attack), health(prototype->health),
+          maxHealth(prototype->health), speed(prototype->speed), range(prototype->range) { flags |= UNIT; }
+
+    // La copia queda fuera del almacén, con las estadísticas base vigentes de la
+    // original (los modificadores pertenecen al mapa y los copia GameMap::cloneFrom)
+    Unit(const Unit& other)
+        : Card(other), attack(other.baseStat(other.attack, &UnitStatStore::attack)), health(other.getHealth()),
+          maxHealth(other.getMaxHealth()), speed(other.baseStat(other.speed, &UnitStatStore::speed)),
+          range(other.baseStat(other.range, &UnitStatStore::range)), x(other.x), y(other.y) {}
+
+    CardPtr clone() const override { return GameArena::makeShared<Unit>(*this); }
 
     // Getters
-    uint8_t getAttack() const { return attack; }
-    uint8_t getHealth() const { return health; }
-    uint8_t getMaxHealth() const { return maxHealth; }
-    uint8_t getSpeed() const { return speed; }
-    uint8_t getRange() const { return range; }
+    uint8_t getAttack() const { return stat(attack, &UnitStatStore::attack); }
+    uint8_t getHealth() const { return stat(health, &UnitStatStore::health); }
+    uint8_t getMaxHealth() const { return stat(maxHealth, &UnitStatStore::maxHealth); }
+    uint8_t getSpeed() const { return stat(speed, &UnitStatStore::speed); }
+    uint8_t getRange() const { return stat(range, &UnitStatStore::range); }
 
     // Setters
-    void setAttack(uint8_t newAttack) { attack = newAttack; }
-    void setHealth(uint8_t newHealth) { health = (newHealth > maxHealth) ? maxHealth : newHealth; }
+    void setAttack(uint8_t newAttack) { writeStat(attack, &UnitStatStore::attack, newAttack); }
+    void setHealth(uint8_t newHealth) { writeStat(health, &UnitStatStore::health, std::min(newHealth, getMaxHealth())); }
     void setMaxHealth(uint8_t newMaxHealth) { 
-        maxHealth = newMaxHealth; 
-        if (health > maxHealth) health = maxHealth;
+        writeStat(maxHealth, &UnitStatStore::maxHealth, newMaxHealth); 
+        if (getHealth() > newMaxHealth) setHealth(newMaxHealth);
+    }
+    void setSpeed(uint8_t newSpeed) { writeStat(speed, &UnitStatStore::speed, newSpeed); }
+    void setRange(uint8_t newRange) { writeStat(range, &UnitStatStore::range, newRange); }
+
+    // Solo GameMap: vuelca las estadísticas al almacén al colocar la unidad
+    // y las recupera al retirarla
+    void attachStats(UnitStatStore& store, EntityId entity) {
+        store.load(entity, attack, health, maxHealth, speed, range);
+        statStore = &store;
+        statEntity = entity;
+        flags |= ON_MAP;
+    }
+    void detachStats() {
+        if (!statStore) return;
+        attack = baseStat(attack, &UnitStatStore::attack);
+        health = getHealth();
+        maxHealth = getMaxHealth();
+        speed = baseStat(speed, &UnitStatStore::speed);
+        range = baseStat(range, &UnitStatStore::range);
+        statStore->release(statEntity);
+        statStore = nullptr;
+        statEntity = NO_ENTITY;
+        flags &= ~ON_MAP;
     }
-    void setSpeed(uint8_t newSpeed) { speed = newSpeed; }
-    void setRange(uint8_t newRange) { range = newRange; }
+
+    // Handle de la unidad en el mapa (NO_ENTITY fuera de él): fuente de sus auras
+    EntityId getEntity() const { return statEntity; }
 
     // Position methods
     std::pair<uint8_t, uint8_t> getCoordinates() const { return {x, y}; }
@@ -94,57 +214,68 @@ public:
 
     // Combat methods
     void takeDamage(uint8_t damage) {
-        health = (damage >= health) ? 0 : health - damage;
+        const uint8_t current = getHealth();
+        writeStat(health, &UnitStatStore::health, (damage >= current) ? 0 : current - damage);
     }
 
     void heal(uint8_t healAmount) {
-        health = (health + healAmount > maxHealth) ? maxHealth : health + healAmount;
+        const uint8_t current = getHealth();
+        writeStat(health, &UnitStatStore::health, (current + healAmount > getMaxHealth()) ? getMaxHealth() : current + healAmount);
     }
 
-    bool isAlive() const { return health > 0; }
-    
-    // Virtual method para identificar leyendas (por defecto false para Unit normal)
-    virtual bool isLegend() const { return false; }
+    bool isAlive() const { return getHealth() > 0; }
 
     std::string format() const override {
-        return "[Unit] " + name + " (ID: " + std::to_string(id) + ")\n" +
-               "Cost: " + std::to_string(cost) + " | Attack: " + std::to_string(attack) + 
-               " | Health: " + std::to_string(health) + "/" + std::to_string(maxHealth) + "\n" +
-               "Speed: " + std::to_string(speed) + " | Range: " + std::to_string(range) + "\n" +
+        return "[Unit] " + getName() + " (ID: " + std::to_string(getId()) + ")\n" +
+               "Cost: " + std::to_string(cost) + " | Attack: " + std::to_string(getAttack()) + 
+               " | Health: " + std::to_string(getHealth()) + "/" + std::to_string(getMaxHealth()) + "\n" +
+               "Speed: " + std::to_string(getSpeed()) + " | Range: " + std::to_string(getRange()) + "\n" +
                "Owner: " + std::to_string(owner) + "\n" +
-               "Description: " + description;
+               "Description: " + getDescription();
     }
 };
 
 class Spell : public Card {
 public:
+    static constexpr uint8_t KIND = SPELL;
+
     Spell(uint8_t cardId, const std::string& cardName, uint8_t cardCost, 
           const std::string& desc, PlayerId ownerId, const std::string& image = "")
-        : Card(cardId, cardName, cardCost, desc, ownerId, image) {}
+        : Card(cardId, cardName, cardCost, desc, ownerId, image) { flags |= SPELL; }
+
+    Spell(CardPrototypePtr cardPrototype, PlayerId ownerId)
+        : Card(std::move(cardPrototype), ownerId) { flags |= SPELL; }
+
+    CardPtr clone() const override { return GameArena::makeShared<Spell>(*this); }
 
     std::string format() const override {
-        return "[Spell] " + name + " (ID: " + std::to_string(id) + ")\n" +
+        return "[Spell] " + getName() + " (ID: " + std::to_string(getId()) + ")\n" +
                "Cost: " + std::to_string(cost) + "\n" +
                "Owner: " + std::to_string(owner) + "\n" +
-               "Description: " + description;
+               "Description: " + getDescription();
     }
 };
 
 class Legend : public Unit {
 public:
+    static constexpr uint8_t KIND = UNIT | LEGEND;
+
     Legend(uint8_t cardId, const std::string& cardName, uint8_t cardCost, 
            const std::string& desc, PlayerId ownerId, uint8_t atk, uint8_t hp, 
            uint8_t spd, uint8_t rng, const std::string& image = "")
-        : Unit(cardId, cardName, cardCost, desc, ownerId, atk, hp, spd, rng, image) {}
+        : Unit(cardId, cardName, cardCost, desc, ownerId, atk, hp, spd, rng, image) { flags |= LEGEND; }
+
+    Legend(CardPrototypePtr cardPrototype, PlayerId ownerId)
+        : Unit(std::move(cardPrototype), ownerId) { flags |= LEGEND; }
 
-    bool isLegend() const { return true; }
+    CardPtr clone() const override { return GameArena::makeShared<Legend>(*this); }
 
     std::string format() const override {
-        return "[Legend] " + name + " (ID: " + std::to_string(id) + ")\n" +
-               "Cost: " + std::to_string(cost) + " | Attack: " + std::to_string(attack) + 
-               " | Health: " + std::to_string(health) + "/" + std::to_string(maxHealth) + "\n" +
-               "Speed: " + std::to_string(speed) + " | Range: " + std::to_string(range) + "\n" +
+        return "[Legend] " + getName() + " (ID: " + std::to_string(getId()) + ")\n" +
+               "Cost: " + std::to_string(cost) + " | Attack: " + std::to_string(getAttack()) + 
+               " | Health: " + std::to_string(getHealth()) + "/" + std::to_string(getMaxHealth()) + "\n" +
+               "Speed: " + std::to_string(getSpeed()) + " | Range: " + std::to_string(getRange()) + "\n" +
                "Owner: " + std::to_string(owner) + "\n" +
-               "Description: " + description;
+               "Description: " + getDescription();
     }
 };
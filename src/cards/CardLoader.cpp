@@ -2,6 +2,8 @@
 #include <fstream>
 #include <print>
 #include <stdexcept>
+#include <mutex>
+#include "../../libs/flat_hash_map.hpp"
 #include "../../libs/json.hpp"
 #include "../effects/ComposedEffectFactory.hpp"
 
@@ -48,6 +50,24 @@ std::vector<CardLoader::DeckConfig> CardLoader::loadDecksFromFile(const std::str
     return decks;
 }
 
+CardLoader::DeckCatalog CardLoader::loadCatalog(const std::string& filename) {
+    static std::mutex cacheMutex;
+    static ska::flat_hash_map<std::string, DeckCatalog> cache;
+    
+    std::lock_guard lock(cacheMutex);
+    auto it = cache.find(filename);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    
+    // La caché vive todo el proceso: nada de ella puede salir de la arena de
+    // una partida, aunque se cargue desde un DeckBuilder
+    GameArena::Detached detached;
+    auto catalog = std::make_shared<const std::vector<DeckConfig>>(loadDecksFromFile(filename));
+    cache.emplace(filename, catalog);
+    return catalog;
+}
+
 CardLoader::DeckConfig CardLoader::parseDeck(const nlohmann::json& deckJson) {
     DeckConfig deck;
     
@@ -90,9 +110,31 @@ CardLoader::CardConfig CardLoader::parseCard(const nlohmann::json& cardJson) {
         }
     }
     
+    card.prototype = buildPrototype(card);
     return card;
 }
 
+CardPrototypePtr CardLoader::buildPrototype(const CardConfig& cardConfig) {
+    auto prototype = std::make_shared<CardPrototype>();
+    prototype->id = static_cast<uint8_t>(cardConfig.id);
+    prototype->cost = cardConfig.cost;
+    prototype->name = Symbol(cardConfig.name);
+    prototype->description = cardConfig.description;
+    prototype->attack = cardConfig.attack;
+    prototype->health = cardConfig.health;
+    prototype->speed = cardConfig.speed;
+    prototype->range = cardConfig.range;
+    
+    if (cardConfig.type == "unit") {
+        prototype->kind = Card::UNIT;
+    } else if (cardConfig.type == "legend") {
+        prototype->kind = Card::UNIT | Card::LEGEND;
+    } else if (cardConfig.type == "spell") {
+        prototype->kind = Card::SPELL;
+    }
+    return prototype;
+}
+
 CardLoader::EffectConfig CardLoader::parseEffect(const nlohmann::json& effectJson) {
     EffectConfig effect;
     
@@ -133,49 +175,19 @@ std::vector<CardPtr> CardLoader::createCardsFromConfig(const DeckConfig& deckCon
     std::vector<CardPtr> cards;
     
     for (const auto& cardConfig : deckConfig.cards) {
+        // Las configuraciones construidas a mano pueden no traer prototipo
+        CardPrototypePtr prototype = cardConfig.prototype ? cardConfig.prototype : buildPrototype(cardConfig);
         CardPtr card;
         
-        // Create the appropriate card type
-        if (cardConfig.type == "unit") {
-            auto unit = std::make_shared<Unit>(
-                cardConfig.id,
-                cardConfig.name,
-                cardConfig.cost,
-                cardConfig.description,
-                owner,
-                cardConfig.attack,
-                cardConfig.health,
-                cardConfig.speed,
-                cardConfig.range
-            );
-            
-            card = unit;
+        // Create the appropriate card type (the instance only holds mutable state)
+        if (prototype->kind & Card::LEGEND) {
+            card = GameArena::makeShared<Legend>(prototype, owner);
         }
-        else if (cardConfig.type == "legend") {
-            auto legend = std::make_shared<Legend>(
-                cardConfig.id,
-                cardConfig.name,
-                cardConfig.cost,
-                cardConfig.description,
-                owner,
-                cardConfig.attack,
-                cardConfig.health,
-                cardConfig.speed,
-                cardConfig.range
-            );
-            
-            card = legend;
+        else if (prototype->kind & Card::UNIT) {
+            card = GameArena::makeShared<Unit>(prototype, owner);
         }
-        else if (cardConfig.type == "spell") {
-            auto spell = std::make_shared<Spell>(
-                cardConfig.id,
-                cardConfig.name,
-                cardConfig.cost,
-                cardConfig.description,
-                owner
-            );
-            
-            card = spell;
+        else if (prototype->kind & Card::SPELL) {
+            card = GameArena::makeShared<Spell>(prototype, owner);
         }
         else {
             std::println("Unknown card type: {}", cardConfig.type);
@@ -216,7 +228,8 @@ EffectPtr CardLoader::createEffectFromConfig(const EffectConfig& config, CardPtr
             config.directions,// Direcciones (vector de enums)
             config.attribute, // Atributo (string)
             config.x,         // Posición X
-            config.y          // Posición Y
+            config.y,         // Posición Y
+            config.duration   // Duración (0 = instantáneo)
         );
         
         if (effect) {
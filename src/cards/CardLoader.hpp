@@ -51,6 +51,9 @@ public:
         uint8_t range = 1;
         
         std::vector<EffectConfig> effects;
+        
+        // Datos inmutables compartidos por todas las instancias de esta carta
+        CardPrototypePtr prototype;
     };
     
     struct DeckConfig {
@@ -61,7 +64,12 @@ public:
     // Load deck configuration from JSON file
     static std::vector<DeckConfig> loadDecksFromFile(const std::string& filename);
     
-    // Create actual card objects from configuration
+    // Catálogo compartido: el archivo se lee y se convierte en prototipos una sola
+    // vez por ruta; las siguientes llamadas devuelven el mismo catálogo
+    using DeckCatalog = std::shared_ptr<const std::vector<DeckConfig>>;
+    static DeckCatalog loadCatalog(const std::string& filename);
+    
+    // Create actual card objects from configuration (instances of the config's prototypes)
     static std::vector<CardPtr> createCardsFromConfig(const DeckConfig& deckConfig, PlayerId owner);
     
 private:
@@ -69,6 +77,7 @@ private:
     static EffectConfig parseEffect(const nlohmann::json& effectJson);
     static CardConfig parseCard(const nlohmann::json& cardJson);
     static DeckConfig parseDeck(const nlohmann::json& deckJson);
+    static CardPrototypePtr buildPrototype(const CardConfig& cardConfig);
     
     // Helper to convert string to Adjacency
     static GameMap::Adjacency parseDirection(const std::string& direction);
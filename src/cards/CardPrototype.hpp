@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "../utils/Symbol.hpp"
+
+// Datos inmutables de una carta: se construyen una vez por archivo de mazos
+// (CardLoader::loadCatalog) y los comparten todas las partidas. Cada Card solo
+// guarda el estado mutable (dueño, coste, estadísticas, posición) y un
+// puntero a su prototipo.
+struct CardPrototype {
+    uint8_t id = 0;
+    uint8_t kind = 0;        // Card::Flags del tipo concreto (UNIT, LEGEND, SPELL)
+    uint8_t cost = 0;
+    Symbol name;             // Internado: el mismo nombre en varios mazos o archivos se guarda una vez
+    std::string description;
+    std::string imageLink;
+
+    // Estadísticas base (solo unidades y leyendas)
+    uint8_t attack = 0;
+    uint8_t health = 0;
+    uint8_t speed = 1;
+    uint8_t range = 1;
+};
+
+using CardPrototypePtr = std::shared_ptr<const CardPrototype>;
@@ -14,54 +14,86 @@ private:
     EffectImplPtr effectImpl;
     std::vector<TriggerPtr> triggers;
     TargetSelectorPtr targetSelector;
+    TriggerMask triggerMask = 0;  // Acciones de sus triggers, calculadas al construirlo
+
+    void computeTriggerMask() {
+        triggerMask = 0;
+        for (const auto& trigger : triggers) triggerMask |= triggerBit(trigger->getAction());
+    }
 
 public:
     // Constructor con un solo trigger
     ComposedEffect(EffectImplPtr impl, TriggerPtr trigger, TargetSelectorPtr selector, CardPtr src, PlayerId ownerId) 
-        : Effect(src, ownerId, impl->getName()), effectImpl(impl), targetSelector(selector) {
+        : Effect(src, ownerId, impl->getSymbol()), effectImpl(impl), targetSelector(selector) {
         triggers.push_back(trigger);
+        computeTriggerMask();
     }
     
     // Constructor con múltiples triggers
     ComposedEffect(EffectImplPtr impl, const std::vector<TriggerPtr>& triggerList, TargetSelectorPtr selector, CardPtr src, PlayerId ownerId) 
-        : Effect(src, ownerId, impl->getName()), effectImpl(impl), triggers(triggerList), targetSelector(selector) {}
+        : Effect(src, ownerId, impl->getSymbol()), effectImpl(impl), triggers(triggerList), targetSelector(selector) {
+        computeTriggerMask();
+    }
     
     // Implementar la verificación de efectos compuestos
-    bool checkEffect(GameMap& gameMap, MapCell* triggerCell, std::list<MapCell*> targetCells) override {
+    bool checkEffect(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
         (void)targetCells; // Suprimir warning de parámetro no usado
         
-        // Verificar si alguno de los triggers debe activarse
-        bool shouldActivate = false;
+        // Si ningún trigger se activa, no activar el efecto
+        return shouldTrigger(gameMap, triggerCell) && isApplicable(gameMap, triggerCell);
+    }
+    
+    // Verificar si alguno de los triggers debe activarse
+    bool shouldTrigger(GameMap& gameMap, MapCell* triggerCell) override {
         for (auto& trigger : triggers) {
-            if (trigger->shouldActivate(gameMap, triggerCell)) {
-                shouldActivate = true;
-                break;
-            }
+            if (trigger->shouldActivate(gameMap, triggerCell)) return true;
         }
-        
-        // Si ningún trigger se activa, no activar el efecto
-        if (!shouldActivate) return false;
-        
-        // Seleccionar objetivos usando el TargetSelector
-        auto selectedTargets = targetSelector->selectTargets(gameMap, triggerCell);
-        
-        // Verificar si el efecto es aplicable con los objetivos seleccionados
-        return effectImpl->isApplicable(gameMap, triggerCell, selectedTargets);
+        return false;
     }
     
-    // Implementar la aplicación de efectos compuestos
-    void apply(GameMap& map, MapCell* triggerCell, const std::list<MapCell*>& affectedCells) override {
-        (void)affectedCells; // Suprimir warning de parámetro no usado
-        
-        // Seleccionar objetivos usando el TargetSelector
-        auto selectedTargets = targetSelector->selectTargets(map, triggerCell);
-        
-        // Aplicar la implementación del efecto a los objetivos seleccionados
-        effectImpl->apply(map, triggerCell, selectedTargets);
+    // Verificar si el efecto es aplicable con los objetivos del TargetSelector
+    bool isApplicable(GameMap& gameMap, MapCell* triggerCell) override {
+        return isApplicable(gameMap, triggerCell, selectTargets(gameMap, triggerCell));
+    }
+    
+    // Legacy: equivale a resolve sin GameState (vuelve a seleccionar y comprobar)
+    void apply(GameMap& map, MapCell* triggerCell, const CellList& affectedCells) override {
+        resolve(map, triggerCell, nullptr, affectedCells);
+    }
+    
+    // Activación por partes sin repetir la selección: quien necesite comprobar
+    // antes de aplicar selecciona una vez y pasa la misma lista a las dos
+    CellList selectTargets(GameMap& map, MapCell* triggerCell) {
+        return targetSelector->selectTargets(map, triggerCell);
+    }
+    
+    bool isApplicable(GameMap& map, MapCell* triggerCell, const CellList& targets) {
+        return effectImpl->isApplicable(map, triggerCell, targets);
+    }
+    
+    // Aplica la implementación a objetivos ya seleccionados y actualiza su parte del hash
+    void applyTo(GameMap& map, MapCell* triggerCell, const CellList& targets) {
+        effectImpl->apply(map, triggerCell, targets);
+        // Las implementaciones solo modifican sus objetivos
+        for (MapCell* cell : targets) {
+            map.refreshUnit(cell);
+        }
+    }
+    
+    // Una activación selecciona los objetivos una vez: los mismos sirven para
+    // comprobar si es aplicable y para aplicarlo. El trigger ya se activó, así
+    // que los efectos de estado de juego no lo vuelven a consultar
+    bool resolve(GameMap& map, MapCell* triggerCell, GameState* gameState, const CellList& affectedCells) override {
+        (void)affectedCells; // Los objetivos los decide el TargetSelector
+        const CellList selectedTargets = selectTargets(map, triggerCell);
+        if (!isApplicable(map, triggerCell, selectedTargets)) return false;
+        applyTo(map, triggerCell, selectedTargets);
+        if (gameState) effectImpl->applyToGameState(map, triggerCell, gameState);
+        return true;
     }
     
     // Método adicional para aplicar efectos de estado de juego
-    void applyToGameState(GameMap& map, MapCell* triggerCell, GameState* gameState) {
+    void applyToGameState(GameMap& map, MapCell* triggerCell, GameState* gameState) override {
         // Solo aplicar si algún trigger está activo
         bool shouldActivate = false;
         for (auto& trigger : triggers) {
@@ -78,14 +110,31 @@ public:
     
     // Implementación de execute para cumplir con la interfaz Effect
     void execute(GameMap& gameMap, MapCell* triggerCell) override {
-        // Seleccionar objetivos usando el TargetSelector
-        auto selectedTargets = targetSelector->selectTargets(gameMap, triggerCell);
-        // Verificar si el efecto es aplicable
-        if (checkEffect(gameMap, triggerCell, selectedTargets)) {
-            apply(gameMap, triggerCell, selectedTargets);
-        }
+        if (shouldTrigger(gameMap, triggerCell)) resolve(gameMap, triggerCell, nullptr, {});
+    }
+    
+    void expire(GameMap& gameMap) override { effectImpl->expire(gameMap); }
+    
+    TriggerMask getTriggerMask() const override { return triggerMask; }
+    
+    uint64_t getWatchedCells(const GameMap& gameMap) const override {
+        uint64_t cells = 0;
+        for (const auto& trigger : triggers) cells |= trigger->getWatchedCells(gameMap);
+        return cells;
     }
     
+    // Copia profunda: cada componente se copia con su fuente remapeada
+    EffectPtr clone(CloneContext& context) const override {
+        auto copy = GameArena::makeShared<ComposedEffect>(*this);
+        // Registrada antes de copiar la fuente, cuyos efectos apuntan a este
+        context.record(this, copy);
+        copy->source = context.card(source);
+        copy->effectImpl = effectImpl->clone(context);
+        for (auto& trigger : copy->triggers) trigger = trigger->clone(context);
+        copy->targetSelector = targetSelector->clone(context);
+        return copy;
+    }
+
     // Getters para el nuevo sistema
     EffectImplPtr getEffectImpl() const { return effectImpl; }
     const std::vector<TriggerPtr>& getTriggers() const { return triggers; }
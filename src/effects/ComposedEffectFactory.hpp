@@ -4,6 +4,7 @@
 #include "../triggers/TriggerFactory.hpp"
 #include "../targeting/TargetSelectorFactory.hpp"
 #include "../game/GameMap.hpp"
+#include "../utils/GameArena.hpp"
 #include "../lex/ConfigLexer.hpp"
 #include <memory>
 #include <vector>
@@ -16,8 +17,8 @@ public:
                                       int attackChange, 
                                       TargetSelectorPtr targetSelector,
                                       TriggerPtr trigger) {
-        auto impl = std::static_pointer_cast<EffectImpl>(std::make_shared<AttackModifierEffectImpl>(source, owner, attackChange));
-        return std::make_shared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
+        auto impl = std::static_pointer_cast<EffectImpl>(GameArena::makeShared<AttackModifierEffectImpl>(source, owner, attackChange));
+        return GameArena::makeShared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
     }
     
     // Método para crear un efecto de modificación de ataque con múltiples triggers
@@ -25,8 +26,8 @@ public:
                                       int attackChange, 
                                       TargetSelectorPtr targetSelector,
                                       const std::vector<TriggerPtr>& triggers) {
-        auto impl = std::static_pointer_cast<EffectImpl>(std::make_shared<AttackModifierEffectImpl>(source, owner, attackChange));
-        return std::make_shared<ComposedEffect>(impl, triggers, targetSelector, source, owner);
+        auto impl = std::static_pointer_cast<EffectImpl>(GameArena::makeShared<AttackModifierEffectImpl>(source, owner, attackChange));
+        return GameArena::makeShared<ComposedEffect>(impl, triggers, targetSelector, source, owner);
     }
     
     // Método para crear un efecto de daño
@@ -34,8 +35,8 @@ public:
                                       uint8_t damage,
                                       TargetSelectorPtr targetSelector,
                                       TriggerPtr trigger) {
-        auto impl = std::make_shared<DamageEffectImpl>(source, owner, damage);
-        return std::make_shared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
+        auto impl = GameArena::makeShared<DamageEffectImpl>(source, owner, damage);
+        return GameArena::makeShared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
     }
     
     // Método para crear un efecto de curación
@@ -43,17 +44,17 @@ public:
                                     uint8_t healAmount,
                                     TargetSelectorPtr targetSelector,
                                     TriggerPtr trigger) {
-        auto impl = std::make_shared<HealEffectImpl>(source, owner, healAmount);
-        return std::make_shared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
+        auto impl = GameArena::makeShared<HealEffectImpl>(source, owner, healAmount);
+        return GameArena::makeShared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
     }
     
     // Método para crear un efecto de robar cartas
     static EffectPtr createDrawCardsEffect(CardPtr source, PlayerId owner, 
                                          uint8_t cardCount,
                                          TriggerPtr trigger) {
-        auto impl = std::make_shared<DrawCardsEffectImpl>(source, owner, cardCount);
+        auto impl = GameArena::makeShared<DrawCardsEffectImpl>(source, owner, cardCount);
         auto gameStateSelector = TargetSelectorFactory::createGameStateSelector(source, owner);
-        return std::make_shared<ComposedEffect>(impl, trigger, gameStateSelector, source, owner);
+        return GameArena::makeShared<ComposedEffect>(impl, trigger, gameStateSelector, source, owner);
     }
     
     // Método principal para crear efectos desde configuración JSON usando enums
@@ -65,7 +66,8 @@ public:
                                     ConfigLexer::TargetFilter targetFilter = ConfigLexer::TargetFilter::ANY,
                                     const std::vector<GameMap::Adjacency>& directions = {},
                                     const std::string& attribute = "",
-                                    uint8_t x = 0, uint8_t y = 0) {
+                                    uint8_t x = 0, uint8_t y = 0,
+                                    int duration = 0) {
         
         // Crear trigger usando enums
         TriggerPtr trigger = nullptr;
@@ -106,41 +108,45 @@ public:
         switch (effectType) {
             case ConfigLexer::EffectType::ATTRIBUTE_MODIFIER:
                 // Crear el efecto apropiado según el atributo
+                // Con duración (temporal o permanente), ataque, velocidad y alcance son auras
+                // de la fuente; solo los instantáneos (duration == 0) cambian el valor base
                 if (attribute == "attack") {
-                    impl = std::make_shared<AttackModifierEffectImpl>(source, owner, value);
+                    impl = GameArena::makeShared<AttackModifierEffectImpl>(source, owner, value, duration != 0);
                 } else if (attribute == "health") {
-                    impl = std::make_shared<HealthModifierEffectImpl>(source, owner, value);
+                    impl = GameArena::makeShared<HealthModifierEffectImpl>(source, owner, value);
                 } else if (attribute == "speed") {
-                    impl = std::make_shared<SpeedModifierEffectImpl>(source, owner, value);
+                    impl = GameArena::makeShared<SpeedModifierEffectImpl>(source, owner, value, duration != 0);
                 } else if (attribute == "range") {
-                    impl = std::make_shared<RangeModifierEffectImpl>(source, owner, value);
+                    impl = GameArena::makeShared<RangeModifierEffectImpl>(source, owner, value, duration != 0);
                 } else {
                     // Por defecto, attack
-                    impl = std::make_shared<AttackModifierEffectImpl>(source, owner, value);
+                    impl = GameArena::makeShared<AttackModifierEffectImpl>(source, owner, value, duration != 0);
                 }
                 break;
             case ConfigLexer::EffectType::DIRECT_DAMAGE:
-                impl = std::make_shared<DamageEffectImpl>(source, owner, std::abs(value));
+                impl = GameArena::makeShared<DamageEffectImpl>(source, owner, std::abs(value));
                 break;
             case ConfigLexer::EffectType::HEAL:
-                impl = std::make_shared<HealEffectImpl>(source, owner, std::abs(value));
+                impl = GameArena::makeShared<HealEffectImpl>(source, owner, std::abs(value));
                 break;
             case ConfigLexer::EffectType::REFLECT_DAMAGE:
-                impl = std::make_shared<DamageEffectImpl>(source, owner, std::abs(value)); // Simplificado por ahora
+                impl = GameArena::makeShared<DamageEffectImpl>(source, owner, std::abs(value)); // Simplificado por ahora
                 break;
             case ConfigLexer::EffectType::DRAW_CARDS:
-                impl = std::make_shared<DrawCardsEffectImpl>(source, owner, std::abs(value));
+                impl = GameArena::makeShared<DrawCardsEffectImpl>(source, owner, std::abs(value));
                 targetSelector = TargetSelectorFactory::createGameStateSelector(source, owner);
                 break;
             case ConfigLexer::EffectType::DESTROY:
-                impl = std::make_shared<DestroyEffectImpl>(source, owner);
+                impl = GameArena::makeShared<DestroyEffectImpl>(source, owner);
                 break;
         }
         
         if (!impl) return nullptr;
         
         // Crear el efecto compuesto
-        return std::make_shared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
+        auto effect = GameArena::makeShared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
+        effect->setDuration(duration);
+        return effect;
     }
     
     // Método principal para crear efectos desde configuración JSON (legacy - strings)
@@ -184,23 +190,23 @@ public:
         EffectImplPtr impl = nullptr;
         
         if (effectType == "attack_modifier" || effectType == "attack_buff" || effectType == "attack_debuff") {
-            impl = std::make_shared<AttackModifierEffectImpl>(source, owner, value);
+            impl = GameArena::makeShared<AttackModifierEffectImpl>(source, owner, value);
         } else if (effectType == "health_modifier" || effectType == "health_buff" || effectType == "health_debuff") {
-            impl = std::make_shared<HealthModifierEffectImpl>(source, owner, value);
+            impl = GameArena::makeShared<HealthModifierEffectImpl>(source, owner, value);
         } else if (effectType == "damage") {
-            impl = std::make_shared<DamageEffectImpl>(source, owner, std::abs(value));
+            impl = GameArena::makeShared<DamageEffectImpl>(source, owner, std::abs(value));
         } else if (effectType == "heal") {
-            impl = std::make_shared<HealEffectImpl>(source, owner, std::abs(value));
+            impl = GameArena::makeShared<HealEffectImpl>(source, owner, std::abs(value));
         } else if (effectType == "range_modifier" || effectType == "range_buff" || effectType == "range_debuff") {
-            impl = std::make_shared<RangeModifierEffectImpl>(source, owner, value);
+            impl = GameArena::makeShared<RangeModifierEffectImpl>(source, owner, value);
         } else if (effectType == "speed_modifier" || effectType == "speed_buff" || effectType == "speed_debuff") {
-            impl = std::make_shared<SpeedModifierEffectImpl>(source, owner, value);
+            impl = GameArena::makeShared<SpeedModifierEffectImpl>(source, owner, value);
         } else if (effectType == "draw_cards") {
-            impl = std::make_shared<DrawCardsEffectImpl>(source, owner, std::abs(value));
+            impl = GameArena::makeShared<DrawCardsEffectImpl>(source, owner, std::abs(value));
             // Para efectos de estado de juego, forzar GameStateTargetSelector
             targetSelector = TargetSelectorFactory::createGameStateSelector(source, owner);
         } else if (effectType == "add_mana") {
-            impl = std::make_shared<AddManaEffectImpl>(source, owner, std::abs(value));
+            impl = GameArena::makeShared<AddManaEffectImpl>(source, owner, std::abs(value));
             targetSelector = TargetSelectorFactory::createGameStateSelector(source, owner);
         } else {
             // Tipo de efecto desconocido
@@ -210,7 +216,7 @@ public:
         if (!impl) return nullptr;
         
         // Crear el efecto compuesto
-        return std::make_shared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
+        return GameArena::makeShared<ComposedEffect>(impl, trigger, targetSelector, source, owner);
     }
     
     // Método legacy para compatibilidad con código existente
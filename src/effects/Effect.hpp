@@ -1,11 +1,15 @@
 #pragma once
 #include "../utils/Types.hpp"
 #include <string>
+#include "../utils/Symbol.hpp"
 #include <memory>
+#include <algorithm>
 
 // Forward declarations
 class GameMap;
 class MapCell;
+class GameState;
+class CloneContext;
 
 // Clase base minimal para efectos - mantiene compatibilidad con el sistema legacy
 // mientras migramos completamente al nuevo sistema basado en EffectImpl
@@ -13,24 +17,71 @@ class Effect {
 protected:
     CardPtr source;
     PlayerId owner;
-    std::string name;
+    Symbol name;  // Internado: compartido por todas las instancias
+    int8_t duration = -1;  // Turnos que permanece en la pila: 0 = instantáneo, -1 = persistente
 
 public:
-    Effect(CardPtr src, PlayerId ownerId, const std::string& effectName) 
+    Effect(CardPtr src, PlayerId ownerId, const Symbol& effectName) 
         : source(src), owner(ownerId), name(effectName) {}
     
     virtual ~Effect() = default;
     
     // Métodos básicos que deben ser implementados por las clases derivadas
     virtual void execute(GameMap& gameMap, MapCell* triggerCell) = 0;
-    virtual bool checkEffect(GameMap& gameMap, MapCell* triggerCell, std::list<MapCell*> targetCells) = 0;
-    virtual void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& affectedCells) = 0;
+    virtual bool checkEffect(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) = 0;
+    virtual void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& affectedCells) = 0;
     virtual operator std::string() const = 0;
     
+    // Copia profunda para GameState::clone (fuente y componentes remapeados)
+    virtual std::shared_ptr<Effect> clone(CloneContext& context) const = 0;
+    
+    // checkEffect por partes, para los eventos de posición: un efecto suscrito
+    // cuyo trigger no se activa sigue esperando, y solo sale de la pila si
+    // deja de ser aplicable. Los efectos legacy no distinguen ambos casos
+    virtual bool shouldTrigger(GameMap& gameMap, MapCell* triggerCell) {
+        (void)gameMap; (void)triggerCell;
+        return true;
+    }
+    virtual bool isApplicable(GameMap& gameMap, MapCell* triggerCell) {
+        return checkEffect(gameMap, triggerCell, {});
+    }
+    
+    // Activación desde EffectStack, con el trigger ya comprobado (shouldTrigger):
+    // comprueba si es aplicable y lo aplica. false si no lo es. ComposedEffect
+    // selecciona los objetivos una sola vez para ambas cosas
+    virtual bool resolve(GameMap& gameMap, MapCell* triggerCell, GameState* gameState,
+                         const CellList& affectedCells = {}) {
+        if (!checkEffect(gameMap, triggerCell, affectedCells)) return false;
+        apply(gameMap, triggerCell, affectedCells);
+        if (gameState) applyToGameState(gameMap, triggerCell, gameState);
+        return true;
+    }
+    
+    // Efectos que también modifican el estado de la partida (robar, maná...);
+    // por defecto no hace nada
+    virtual void applyToGameState(GameMap& gameMap, MapCell* triggerCell, GameState* gameState) {
+        (void)gameMap; (void)triggerCell; (void)gameState;
+    }
+    
+    // Al agotarse su duración (EffectStack::expireTurn): retira lo que el
+    // efecto mantenga en el mapa; por defecto no hace nada
+    virtual void expire(GameMap& gameMap) { (void)gameMap; }
+    
+    // Cubos de EffectStack en los que se registra (EffectStack::addTriggeredEffect);
+    // los efectos legacy solo esperan al jugarse
+    virtual TriggerMask getTriggerMask() const { return triggerBit(TriggerAction::ON_PLAY); }
+    
+    // Celdas a las que se suscribe en los cubos de posición (entrar/salir);
+    // sin triggers propios escucha todas
+    virtual uint64_t getWatchedCells(const GameMap& gameMap) const { (void)gameMap; return ~uint64_t{0}; }
+    
     // Getters
     CardPtr getSource() const { return source; }
     PlayerId getOwner() const { return owner; }
-    const std::string& getName() const { return name; }
+    const std::string& getName() const { return name.str(); }
+    const Symbol& getSymbol() const { return name; }
+    int getDuration() const { return duration; }
+    void setDuration(int turns) { duration = static_cast<int8_t>(std::clamp(turns, -1, 127)); }
 };
 
 // Tipos para compatibilidad
@@ -2,10 +2,13 @@
 #include "../game/GameMap.hpp"
 #include "../game/MapCell.hpp"
 #include "../cards/Card.hpp"
+#include "../game/CloneContext.hpp"
 #include "../targeting/TargetSelector.hpp"
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
+#include "../utils/Symbol.hpp"
 
 // Forward declarations
 class GameState;
@@ -16,24 +19,69 @@ class EffectImpl {
 protected:
     CardPtr source;
     PlayerId owner;
-    std::string name;
+    Symbol name;  // Internado: compartido por todas las instancias
+    // Clave de sus auras en la capa de modificadores: única por efecto y
+    // conservada por clone (los modificadores copiados siguen siendo suyos)
+    UnitStatStore::AuraKey auraKey = nextAuraKey();
+
+    // Implementación de clone() para cada subclase: copia la configuración y el
+    // estado propio y remapea la carta fuente a la partida destino
+    template<typename T>
+    static std::shared_ptr<T> cloneAs(const T& original, CloneContext& context) {
+        auto copy = GameArena::makeShared<T>(original);
+        copy->source = context.card(original.source);
+        return copy;
+    }
+
+    // Handle en el mapa de la unidad fuente (NO_ENTITY si no es una unidad colocada)
+    EntityId sourceEntity() const {
+        const Unit* unit = Card::as<Unit>(source);
+        return unit ? unit->getEntity() : NO_ENTITY;
+    }
+
+    // Las escrituras directas sobre una unidad (applyToCards) no pasan por los
+    // kernels: tras cada una se actualizan su celda y el hash del tablero
+    static void refreshCard(GameMap& gameMap, const Unit& unit) { gameMap.refreshEntity(unit.getEntity()); }
+
+    // Efectos persistentes de una unidad colocada: el cambio es un aura en la
+    // capa de modificadores (sustituye la anterior de este mismo efecto) en vez
+    // de un cambio del valor base. Devuelve false si la fuente no está en el mapa
+    bool applyAura(GameMap& gameMap, UnitStatStore::Column column, const CellList& targetCells, int delta) const {
+        const EntityId entity = sourceEntity();
+        if (entity == NO_ENTITY) return false;
+        gameMap.setAura(auraKey, entity, column, targetCells, delta);
+        return true;
+    }
+
+    void removeAura(GameMap& gameMap, UnitStatStore::Column column) const {
+        gameMap.removeModifiers(auraKey, column);
+    }
+
+    // Claves crecientes desde 1 (NO_AURA queda para los modificadores sin efecto)
+    static UnitStatStore::AuraKey nextAuraKey() {
+        static std::atomic<UnitStatStore::AuraKey> counter{UnitStatStore::NO_AURA};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
 
 public:
-    EffectImpl(CardPtr src, PlayerId ownerId, const std::string& effectName) 
+    EffectImpl(CardPtr src, PlayerId ownerId, const Symbol& effectName) 
         : source(src), owner(ownerId), name(effectName) {}
     
     virtual ~EffectImpl() = default;
     
+    // Copia para GameState::clone, con la fuente remapeada
+    virtual std::shared_ptr<EffectImpl> clone(CloneContext& context) const = 0;
+    
     // Método principal que implementa la lógica del efecto
     // Los targets ya están seleccionados por el TargetSelector
-    virtual void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) = 0;
+    virtual void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) = 0;
     
     // Método alternativo para efectos que afectan cartas directamente
-    virtual void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) {
+    virtual void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) {
         // Por defecto, convertir cartas a celdas y usar apply normal
-        std::list<MapCell*> targetCells;
+        CellList targetCells;
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (const Unit* unit = Card::as<Unit>(card)) {
                 if (unit->isOnMap()) {
                     auto [x, y] = unit->getCoordinates();
                     MapCell* cell = gameMap.at(x, y);
@@ -52,15 +100,18 @@ public:
         (void)gameMap; (void)triggerCell; (void)gameState;
     }
     
+    // Al expirar la duración del efecto: deshace lo que mantenga activo (auras)
+    virtual void expire(GameMap& gameMap) { (void)gameMap; }
+    
     // Método para verificar si el efecto es aplicable (condiciones adicionales)
-    virtual bool isApplicable(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) {
+    virtual bool isApplicable(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) {
         (void)gameMap; (void)triggerCell; (void)targetCells; // Suprimir warnings de parámetros no usados
         
         // Por defecto, verificar que la carta fuente existe y está viva (para unidades)
         if (!source) return false;
         
         // Para cartas de tipo Unit, verificar que están vivas
-        if (auto unit = std::dynamic_pointer_cast<Unit>(source)) {
+        if (const Unit* unit = Card::as<Unit>(source)) {
             if (!unit->isAlive()) return false;
         }
         
@@ -68,11 +119,12 @@ public:
     }
     
     // Getter para el nombre del efecto
-    const std::string& getName() const { return name; }
+    const std::string& getName() const { return name.str(); }
+    const Symbol& getSymbol() const { return name; }
     
     // Operador para conversión a string (para depuración)
     virtual operator std::string() const {
-        return "EffectImpl: " + name;
+        return "EffectImpl: " + name.str();
     }
 };
 
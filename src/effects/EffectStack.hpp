@@ -1,159 +1,370 @@
 #pragma once
-#include <list>
 #include <functional>
 #include <array>
 #include <cstdint>
 #include <string>
 #include <memory>
-#include "../../libs/flat_hash_map.hpp"
+#include <algorithm>
 #include "Effect.hpp"
 #include "ComposedEffect.hpp"
 #include "../game/GameMap.hpp"
+#include "../utils/SmallVector.hpp"
+#include "../../libs/flat_hash_map.hpp"
 
 // Forward declaration
 class GameState;
 
-// Trigger actions for the effect stack - Mantenemos compatibilidad con sistema legacy
-enum class TriggerAction : uint8_t {
-    ON_PLAY = 0,           // Cuando se juega una carta
-    ON_MOVE = 1,           // Cuando una unidad se mueve
-    ON_ATTACK = 2,         // Cuando una unidad ataca
-    ON_COMBAT = 3,         // Durante el combate
-    ON_DRAW = 4,           // Cuando se roba una carta
-    ON_END_OF_TURN = 5,    // Al final del turno
-    ON_START_OF_TURN= 6,   // Al inicio del turno
-    CAST_EFFECT = 7,       // Al lanzar un hechizo
-    ON_POSITION_ENTER = 8, // Cuando una unidad entra en una posición
-    ON_POSITION_EXIT = 9,  // Cuando una unidad sale de una posición
-    MAX_ACTIONS = 10
-};
+// Handle de un efecto en la pila (slot map generacional): generación (16 bits)
+// | cubo (4 bits) | slot (12 bits). Añadir, quitar y consultar son O(1); un
+// handle de un efecto ya retirado no coincide con la generación del slot y
+// se ignora. 0 nunca es un handle válido (las generaciones empiezan en 1)
+using EffectHandle = uint32_t;
+constexpr EffectHandle NO_EFFECT = 0;
+// Handles de un efecto registrado en varios cubos (uno por acción de sus triggers)
+using EffectHandles = SmallVector<EffectHandle, 4>;
 
 // Stack to manage game effects - Ahora compatible con ComposedEffect y sistema legacy
 class EffectStack {
 private:
     static constexpr int MAX_TRIGGERS = static_cast<int>(TriggerAction::MAX_ACTIONS);
-    std::array<std::list<EffectPtr>, MAX_TRIGGERS> effectsByTrigger;
-    ska::flat_hash_map<uint32_t, std::list<EffectPtr>::iterator> effectPointers;
-    uint32_t nextEffectId = 1;
+    static_assert(MAX_TRIGGERS <= 16, "El cubo ocupa 4 bits del handle");
+    static constexpr uint32_t SLOT_BITS = 12;
+    static constexpr uint32_t BUCKET_BITS = 4;
+    static constexpr size_t MAX_SLOTS = size_t{1} << SLOT_BITS;
+
+    // Los efectos de una partida caben inline; solo se reserva memoria si un trigger acumula más
+    static constexpr size_t INLINE_EFFECTS = 16;
+    struct Slot {
+        uint16_t generation = 1;
+        EffectPtr effect;       // nullptr: slot libre
+        uint64_t watched = 0;   // Celdas suscritas (solo cubos de posición); se conserva al liberar el slot
+    };
+    // Los efectos se procesan en orden de slot; los slots libres se reutilizan (LIFO)
+    struct Bucket {
+        SmallVector<Slot, INLINE_EFFECTS> slots;
+        SmallVector<uint16_t, INLINE_EFFECTS> freeSlots;
+        uint32_t live = 0;
+    };
+    std::array<Bucket, MAX_TRIGGERS> buckets;
+    // Registro de deshacer de la partida (nullptr si no se registra)
+    GameJournal* journal = nullptr;
+
+    static EffectHandle makeHandle(uint16_t generation, size_t bucket, size_t slot) {
+        return uint32_t{generation} << (SLOT_BITS + BUCKET_BITS) |
+               static_cast<uint32_t>(bucket) << SLOT_BITS | static_cast<uint32_t>(slot);
+    }
+    static size_t bucketOf(EffectHandle handle) { return (handle >> SLOT_BITS) & ((1u << BUCKET_BITS) - 1); }
+    static size_t slotOf(EffectHandle handle) { return handle & (MAX_SLOTS - 1); }
+    static uint16_t generationOf(EffectHandle handle) { return static_cast<uint16_t>(handle >> (SLOT_BITS + BUCKET_BITS)); }
+
+    // Slot vivo al que apunta el handle (nullptr si ya se retiró o no es válido)
+    Slot* find(EffectHandle handle) {
+        const size_t bucket = bucketOf(handle), slot = slotOf(handle);
+        if (bucket >= buckets.size() || slot >= buckets[bucket].slots.size()) return nullptr;
+        Slot& candidate = buckets[bucket].slots[slot];
+        return candidate.effect && candidate.generation == generationOf(handle) ? &candidate : nullptr;
+    }
+
+    // La generación salta el 0 al dar la vuelta: ningún handle vale NO_EFFECT
+    static uint16_t nextGeneration(uint16_t generation) { return generation == UINT16_MAX ? 1 : generation + 1; }
+    static uint16_t previousGeneration(uint16_t generation) { return generation == 1 ? UINT16_MAX : generation - 1; }
+
+    // Suscripciones por celda de los cubos de posición: para cada celda, los
+    // slots (ordenados) de los efectos que la vigilan. processPositionEnter/Exit
+    // solo evalúan a los suscriptores de la celda del evento
+    static constexpr size_t MAX_CELLS = 64;
+    static constexpr size_t SPATIAL_BUCKETS = 2;
+    using CellSubscribers = std::array<SmallVector<uint16_t, 4>, MAX_CELLS>;
+    std::array<CellSubscribers, SPATIAL_BUCKETS> subscribers;
+
+    // Índice en subscribers del cubo (-1 si no es de posición)
+    static int spatialIndex(size_t bucketIndex) {
+        if (bucketIndex == static_cast<size_t>(TriggerAction::ON_POSITION_ENTER)) return 0;
+        if (bucketIndex == static_cast<size_t>(TriggerAction::ON_POSITION_EXIT)) return 1;
+        return -1;
+    }
+
+    void link(size_t bucketIndex, size_t slotIndex, uint64_t cells) {
+        CellSubscribers& lists = subscribers[spatialIndex(bucketIndex)];
+        GameMap::forEachCell(cells, [&](CellIndex cell) {
+            auto& list = lists[cell];
+            list.insert(std::lower_bound(list.begin(), list.end(), slotIndex), static_cast<uint16_t>(slotIndex));
+        });
+    }
+
+    void unlink(size_t bucketIndex, size_t slotIndex, uint64_t cells) {
+        CellSubscribers& lists = subscribers[spatialIndex(bucketIndex)];
+        GameMap::forEachCell(cells, [&](CellIndex cell) {
+            auto& list = lists[cell];
+            list.erase(std::lower_bound(list.begin(), list.end(), slotIndex));
+        });
+    }
+
+    // Registros de posición vivos de cada carta fuente (cubo espacial << SLOT_BITS
+    // | slot): refreshSubscriptions solo toca los efectos de la carta movida
+    using SourceSlots = SmallVector<uint16_t, 4>;
+    ska::flat_hash_map<const Card*, SourceSlots> sourceSlots;
+
+    static uint16_t packSpatial(int spatial, size_t slotIndex) {
+        return static_cast<uint16_t>(spatial << SLOT_BITS | slotIndex);
+    }
+
+    // Altas y bajas del índice al vivir o liberarse un slot (no-op fuera de los cubos de posición)
+    void trackSource(size_t bucketIndex, size_t slotIndex) {
+        const int spatial = spatialIndex(bucketIndex);
+        const Card* source = buckets[bucketIndex].slots[slotIndex].effect->getSource().get();
+        if (spatial >= 0 && source) sourceSlots[source].push_back(packSpatial(spatial, slotIndex));
+    }
+
+    void untrackSource(size_t bucketIndex, size_t slotIndex) {
+        const int spatial = spatialIndex(bucketIndex);
+        const Card* source = buckets[bucketIndex].slots[slotIndex].effect->getSource().get();
+        if (spatial < 0 || !source) return;
+        auto found = sourceSlots.find(source);
+        SourceSlots& slots = found->second;
+        auto entry = std::find(slots.begin(), slots.end(), packSpatial(spatial, slotIndex));
+        *entry = slots.back();
+        slots.pop_back();
+        if (slots.empty()) sourceSlots.erase(found);
+    }
+
+    // Cambia las celdas de un slot; las listas solo contienen slots vivos
+    void applyWatched(size_t bucketIndex, size_t slotIndex, uint64_t cells) {
+        Slot& slot = buckets[bucketIndex].slots[slotIndex];
+        if (slot.effect) {
+            unlink(bucketIndex, slotIndex, slot.watched & ~cells);
+            link(bucketIndex, slotIndex, cells & ~slot.watched);
+        }
+        slot.watched = cells;
+    }
+
+    void setWatched(size_t bucketIndex, size_t slotIndex, uint64_t cells) {
+        const uint64_t previous = buckets[bucketIndex].slots[slotIndex].watched;
+        if (previous == cells) return;
+        if (journal) {
+            journal->record({.op = GameJournal::Op::SUBSCRIBE, .small = static_cast<uint8_t>(bucketIndex),
+                             .index = static_cast<uint32_t>(slotIndex), .value = previous});
+        }
+        applyWatched(bucketIndex, slotIndex, cells);
+    }
+
+    // Evalúa un efecto vivo: lo aplica si se activa y si no lo quita de la pila.
+    // resolve selecciona los objetivos una vez para comprobarlo y aplicarlo
+    void processSlot(size_t bucketIndex, size_t slotIndex, GameMap& gameMap, MapCell* triggerCell,
+                     GameState* gameState, const CellList& affectedCells) {
+        EffectPtr effect = buckets[bucketIndex].slots[slotIndex].effect;
+        if (!effect->shouldTrigger(gameMap, triggerCell) ||
+            !effect->resolve(gameMap, triggerCell, gameState, affectedCells)) {
+            eraseSlot(bucketIndex, slotIndex);
+        }
+    }
+
+    // Suscriptores de la celda del evento, copiados como handles: aplicar un
+    // efecto puede retirar o suscribir otros durante el recorrido. Un
+    // suscriptor cuyo trigger no se activa sigue suscrito
+    void processSubscribers(TriggerAction trigger, GameMap& gameMap, MapCell* triggerCell, GameState* gameState) {
+        if (!triggerCell) return;
+        const size_t bucketIndex = static_cast<size_t>(trigger);
+        const auto& list = subscribers[spatialIndex(bucketIndex)][gameMap.indexOf(triggerCell)];
+        SmallVector<EffectHandle, 16> pending;
+        for (uint16_t slot : list) {
+            pending.push_back(makeHandle(buckets[bucketIndex].slots[slot].generation, bucketIndex, slot));
+        }
+        for (EffectHandle handle : pending) {
+            const Slot* slot = find(handle);
+            if (!slot) continue;
+            EffectPtr effect = slot->effect;
+            if (!effect->shouldTrigger(gameMap, triggerCell)) continue;
+            if (!effect->resolve(gameMap, triggerCell, gameState)) eraseSlot(bucketIndex, slotOf(handle));
+        }
+    }
+
+    // Libera un slot vivo, registrándolo para deshacer
+    void eraseSlot(size_t bucketIndex, size_t slotIndex) {
+        Bucket& bucket = buckets[bucketIndex];
+        Slot& slot = bucket.slots[slotIndex];
+        if (journal) {
+            journal->record({.op = GameJournal::Op::EFFECT_ERASE, .small = static_cast<uint8_t>(bucketIndex),
+                             .index = static_cast<uint32_t>(slotIndex), .effect = slot.effect});
+        }
+        if (slot.watched) unlink(bucketIndex, slotIndex, slot.watched);
+        untrackSource(bucketIndex, slotIndex);
+        slot.effect = nullptr;
+        slot.generation = nextGeneration(slot.generation);
+        bucket.freeSlots.push_back(static_cast<uint16_t>(slotIndex));
+        --bucket.live;
+    }
+
+    // Rueda de expiración indexada por turno: ranura = turno % WHEEL_SLOTS.
+    // expireTurn solo recorre la ranura del turno, no la pila entera; las
+    // entradas de vueltas posteriores (duraciones >= WHEEL_SLOTS) se quedan
+    static constexpr size_t WHEEL_SLOTS = 16;
+    struct Expiry {
+        uint32_t turn;
+        EffectHandle handle;
+    };
+    using WheelSlot = SmallVector<Expiry, 4>;
+    std::array<WheelSlot, WHEEL_SLOTS> expiryWheel;
+
+    static uint64_t packExpiry(const Expiry& expiry) { return uint64_t{expiry.turn} << 32 | expiry.handle; }
 
 public:
     EffectStack() = default;
     
     // Add effect to stack (legacy compatibility)
-    uint32_t addEffect(EffectPtr effect, TriggerAction trigger) {
-        uint32_t effectId = nextEffectId++;
-        auto it = effectsByTrigger[static_cast<size_t>(trigger)].insert(
-            effectsByTrigger[static_cast<size_t>(trigger)].end(), 
-            effect
-        );
-        effectPointers[effectId] = it;
-        return effectId;
+    EffectHandle addEffect(EffectPtr effect, TriggerAction trigger) {
+        const size_t bucketIndex = static_cast<size_t>(trigger);
+        Bucket& bucket = buckets[bucketIndex];
+        const bool reused = !bucket.freeSlots.empty();
+        if (!reused && bucket.slots.size() == MAX_SLOTS) return NO_EFFECT;
+        size_t slotIndex;
+        if (reused) {
+            slotIndex = bucket.freeSlots.back();
+            bucket.freeSlots.pop_back();
+            // El slot libre aún guarda las celdas del efecto anterior (para deshacer su borrado)
+            setWatched(bucketIndex, slotIndex, 0);
+        } else {
+            slotIndex = bucket.slots.size();
+            bucket.slots.emplace_back();
+        }
+        Slot& slot = bucket.slots[slotIndex];
+        slot.effect = std::move(effect);
+        trackSource(bucketIndex, slotIndex);
+        ++bucket.live;
+        if (journal) {
+            journal->record({.op = GameJournal::Op::EFFECT_ADD, .small = static_cast<uint8_t>(bucketIndex),
+                             .index = static_cast<uint32_t>(slotIndex), .value = reused});
+        }
+        return makeHandle(slot.generation, bucketIndex, slotIndex);
+    }
+    
+    // Registra el efecto en el cubo de cada acción de sus triggers
+    // (Effect::getTriggerMask): cada process* solo recorre los efectos que
+    // pueden activarse en él. Sin triggers, espera al jugarse
+    EffectHandles addTriggeredEffect(const EffectPtr& effect) {
+        TriggerMask mask = effect->getTriggerMask();
+        if (mask == 0) mask = triggerBit(TriggerAction::ON_PLAY);
+        EffectHandles handles;
+        for (int trigger = 0; trigger < MAX_TRIGGERS; ++trigger) {
+            if (!(mask >> trigger & 1u)) continue;
+            const EffectHandle handle = addEffect(effect, static_cast<TriggerAction>(trigger));
+            if (handle != NO_EFFECT) handles.push_back(handle);
+        }
+        return handles;
+    }
+    
+    // Igual, suscribiendo los registros de posición a las celdas que vigila
+    EffectHandles addTriggeredEffect(const EffectPtr& effect, const GameMap& gameMap) {
+        EffectHandles handles = addTriggeredEffect(effect);
+        for (EffectHandle handle : handles) subscribe(handle, effect->getWatchedCells(gameMap));
+        return handles;
     }
     
-    // Add ComposedEffect - el sistema lo manejará automáticamente basado en sus triggers internos
-    uint32_t addComposedEffect(std::shared_ptr<ComposedEffect> composedEffect) {
-        // Para efectos compuestos, podemos inferir el trigger principal o usar ON_PLAY por defecto
-        // En una implementación más avanzada, el ComposedEffect podría tener múltiples registros
-        return addEffect(composedEffect, TriggerAction::ON_PLAY);
+    // Add ComposedEffect - registrado en los cubos de sus triggers
+    EffectHandles addComposedEffect(std::shared_ptr<ComposedEffect> composedEffect) {
+        return addTriggeredEffect(composedEffect);
     }
     
     // Overload for default trigger (ON_PLAY)
-    uint32_t addEffect(EffectPtr effect) {
+    EffectHandle addEffect(EffectPtr effect) {
         return addEffect(effect, TriggerAction::ON_PLAY);
     }
     
-    // Remove effect from stack
-    void removeEffect(uint32_t effectId) {
-        auto it = effectPointers.find(effectId);
-        if (it != effectPointers.end()) {
-            auto effectIt = it->second;
-            // Find which trigger list contains this effect
-            for (size_t i = 0; i < effectsByTrigger.size(); ++i) {
-                auto& list = effectsByTrigger[i];
-                // Check if the iterator belongs to this list by comparing with all elements
-                bool found = false;
-                for (auto checkIt = list.begin(); checkIt != list.end(); ++checkIt) {
-                    if (checkIt == effectIt) {
-                        found = true;
-                        break;
-                    }
-                }
-                
-                if (found) {
-                    list.erase(effectIt);
-                    break;
-                }
-            }
-            effectPointers.erase(it);
+    // Remove effect from stack (no-op si el handle ya no es válido)
+    void removeEffect(EffectHandle handle) {
+        if (find(handle)) eraseSlot(bucketOf(handle), slotOf(handle));
+    }
+
+    // Efecto de un handle (nullptr si ya se retiró)
+    EffectPtr getEffect(EffectHandle handle) {
+        const Slot* slot = find(handle);
+        return slot ? slot->effect : nullptr;
+    }
+
+    bool contains(EffectHandle handle) { return find(handle) != nullptr; }
+    
+    // ===== SUSCRIPCIONES POR CELDA =====
+    // Celdas que vigila un efecto de un cubo de posición (no-op en el resto)
+    void subscribe(EffectHandle handle, uint64_t cells) {
+        if (find(handle) && spatialIndex(bucketOf(handle)) >= 0) setWatched(bucketOf(handle), slotOf(handle), cells);
+    }
+
+    // Vuelve a suscribir los efectos de una carta que se ha movido o ha salido
+    // del mapa, O(efectos de la carta) a través de sourceSlots
+    void refreshSubscriptions(const CardPtr& source, const GameMap& gameMap) {
+        auto found = sourceSlots.find(source.get());
+        if (found == sourceSlots.end()) return;
+        for (uint16_t packed : found->second) {
+            const size_t bucketIndex = static_cast<size_t>(
+                packed >> SLOT_BITS ? TriggerAction::ON_POSITION_EXIT : TriggerAction::ON_POSITION_ENTER);
+            const size_t slotIndex = packed & (MAX_SLOTS - 1);
+            setWatched(bucketIndex, slotIndex, buckets[bucketIndex].slots[slotIndex].effect->getWatchedCells(gameMap));
         }
     }
+
+    size_t getSubscriberCount(TriggerAction trigger, CellIndex cell) const {
+        const int spatial = spatialIndex(static_cast<size_t>(trigger));
+        return spatial < 0 ? 0 : subscribers[spatial][cell].size();
+    }
     
+    // ===== EXPIRACIÓN POR DURACIÓN =====
+    // El efecto se quita de la pila en el primer expireTurn(turn) (fin de turno)
+    void scheduleExpiry(EffectHandle handle, uint32_t turn) {
+        const size_t slot = turn % WHEEL_SLOTS;
+        expiryWheel[slot].push_back({turn, handle});
+        if (journal) journal->record({.op = GameJournal::Op::EXPIRY_ADD, .small = static_cast<uint8_t>(slot)});
+    }
+
+    // Quita los efectos que expiran en este turno, O(efectos de la ranura), y
+    // deja que retiren lo que mantenían en el mapa (auras)
+    void expireTurn(uint32_t turn, GameMap& gameMap) {
+        const size_t slot = turn % WHEEL_SLOTS;
+        auto& pending = expiryWheel[slot];
+        for (size_t i = pending.size(); i-- > 0;) {
+            if (pending[i].turn != turn) continue;
+            const Expiry expired = pending[i];
+            if (journal) {
+                journal->record({.op = GameJournal::Op::EXPIRY_REMOVE, .small = static_cast<uint8_t>(slot),
+                                 .index = static_cast<uint32_t>(i), .value = packExpiry(expired)});
+            }
+            pending.erase(pending.begin() + i);
+
+            if (Slot* live = find(expired.handle)) {
+                live->effect->expire(gameMap);
+                eraseSlot(bucketOf(expired.handle), slotOf(expired.handle));
+            }
+        }
+    }
+
+    size_t getScheduledCount() const {
+        size_t count = 0;
+        for (const auto& slot : expiryWheel) count += slot.size();
+        return count;
+    }
+
     // Process all effects for a trigger - Compatible con ComposedEffect y efectos legacy
     void processTrigger(TriggerAction trigger, GameMap& gameMap, MapCell* triggerCell, 
-                       const std::list<MapCell*>& affectedCells = {}) {
-        auto& effects = effectsByTrigger[static_cast<size_t>(trigger)];
+                       const CellList& affectedCells = {}) {
+        const size_t bucketIndex = static_cast<size_t>(trigger);
+        auto& slots = buckets[bucketIndex].slots;
         
-        // Use a safe iteration approach since effects may be removed during processing
-        auto it = effects.begin();
-        while (it != effects.end()) {
-            auto effect = *it;
-            bool keepEffect = effect->checkEffect(gameMap, triggerCell, affectedCells);
-            
-            if (keepEffect) {
-                effect->apply(gameMap, triggerCell, affectedCells);
-                
-                // Para ComposedEffect, también procesar efectos de estado de juego si es necesario
-                if (auto composedEffect = std::dynamic_pointer_cast<ComposedEffect>(effect)) {
-                    // En el futuro, podríamos pasar GameState aquí
-                    // composedEffect->applyToGameState(gameMap, triggerCell, gameState);
-                }
-                
-                ++it;
-            } else {
-                // Find and remove the effectId associated with this effect
-                for (auto pointerIt = effectPointers.begin(); pointerIt != effectPointers.end(); ++pointerIt) {
-                    if (pointerIt->second == it) {
-                        effectPointers.erase(pointerIt);
-                        break;
-                    }
-                }
-                it = effects.erase(it);
-            }
+        // Por índice: aplicar un efecto puede añadir otros al mismo cubo.
+        // Sin GameState aquí: los efectos de estado de juego van por processTriggerWithGameState
+        for (size_t index = 0; index < slots.size(); ++index) {
+            if (slots[index].effect) processSlot(bucketIndex, index, gameMap, triggerCell, nullptr, affectedCells);
         }
     }
     
     // Versión extendida que incluye GameState para efectos compuestos
     void processTriggerWithGameState(TriggerAction trigger, GameMap& gameMap, MapCell* triggerCell, 
-                                   GameState* gameState, const std::list<MapCell*>& affectedCells = {}) {
-        auto& effects = effectsByTrigger[static_cast<size_t>(trigger)];
+                                   GameState* gameState, const CellList& affectedCells = {}) {
+        const size_t bucketIndex = static_cast<size_t>(trigger);
+        auto& slots = buckets[bucketIndex].slots;
         
-        auto it = effects.begin();
-        while (it != effects.end()) {
-            auto effect = *it;
-            bool keepEffect = effect->checkEffect(gameMap, triggerCell, affectedCells);
-            
-            if (keepEffect) {
-                effect->apply(gameMap, triggerCell, affectedCells);
-                
-                // Para ComposedEffect, también procesar efectos de estado de juego
-                if (auto composedEffect = std::dynamic_pointer_cast<ComposedEffect>(effect)) {
-                    composedEffect->applyToGameState(gameMap, triggerCell, gameState);
-                }
-                
-                ++it;
-            } else {
-                // Find and remove the effectId associated with this effect
-                for (auto pointerIt = effectPointers.begin(); pointerIt != effectPointers.end(); ++pointerIt) {
-                    if (pointerIt->second == it) {
-                        effectPointers.erase(pointerIt);
-                        break;
-                    }
-                }
-                it = effects.erase(it);
-            }
+        for (size_t index = 0; index < slots.size(); ++index) {
+            if (slots[index].effect) processSlot(bucketIndex, index, gameMap, triggerCell, gameState, affectedCells);
         }
     }
-    
     // Convenience methods - Legacy compatibility
     void processEndOfTurn(GameMap& gameMap) {
         processTrigger(TriggerAction::ON_END_OF_TURN, gameMap, nullptr);
@@ -180,26 +391,103 @@ public:
         processTriggerWithGameState(TriggerAction::CAST_EFFECT, gameMap, triggerCell, gameState);
     }
     
-    // Método para procesar efectos cuando una unidad entra en una posición
+    // Método para procesar efectos cuando una unidad entra en una posición:
+    // solo los suscritos a esa celda, O(interesados) y no O(efectos de la pila).
+    // Los suscriptores de salida de la celda también reciben la entrada: sus
+    // triggers solo ven al enemigo (y se arman) cuando se les consulta con él dentro
     void processPositionEnter(GameMap& gameMap, MapCell* triggerCell, GameState* gameState = nullptr) {
-        if (gameState) {
-            processTriggerWithGameState(TriggerAction::ON_POSITION_ENTER, gameMap, triggerCell, gameState);
-        } else {
-            processTrigger(TriggerAction::ON_POSITION_ENTER, gameMap, triggerCell);
-        }
+        processSubscribers(TriggerAction::ON_POSITION_ENTER, gameMap, triggerCell, gameState);
+        processSubscribers(TriggerAction::ON_POSITION_EXIT, gameMap, triggerCell, gameState);
+    }
+    
+    // Cuando una unidad sale de una posición (la celda que deja). Los
+    // suscriptores de entrada también la reciben: con la celda vacía no se
+    // activan, pero se rearman para la siguiente entrada
+    void processPositionExit(GameMap& gameMap, MapCell* triggerCell, GameState* gameState = nullptr) {
+        processSubscribers(TriggerAction::ON_POSITION_EXIT, gameMap, triggerCell, gameState);
+        processSubscribers(TriggerAction::ON_POSITION_ENTER, gameMap, triggerCell, gameState);
     }
     
     // Obtener número de efectos por trigger (para depuración)
     size_t getEffectCount(TriggerAction trigger) const {
-        return effectsByTrigger[static_cast<size_t>(trigger)].size();
+        return buckets[static_cast<size_t>(trigger)].live;
+    }
+
+    size_t getEffectCount() const {
+        size_t count = 0;
+        for (const Bucket& bucket : buckets) count += bucket.live;
+        return count;
+    }
+    
+    // Copia la pila de otra partida (mismos handles) con los efectos remapeados
+    void cloneFrom(const EffectStack& other, CloneContext& context) {
+        buckets = other.buckets;
+        for (Bucket& bucket : buckets) {
+            for (Slot& slot : bucket.slots) {
+                if (slot.effect) slot.effect = context.effect(slot.effect);
+            }
+        }
+        expiryWheel = other.expiryWheel;
+        subscribers = other.subscribers;
+        // Las claves son las cartas de la copia: el índice se reconstruye
+        sourceSlots.clear();
+        for (size_t bucketIndex = 0; bucketIndex < buckets.size(); ++bucketIndex) {
+            if (spatialIndex(bucketIndex) < 0) continue;
+            for (size_t slotIndex = 0; slotIndex < buckets[bucketIndex].slots.size(); ++slotIndex) {
+                if (buckets[bucketIndex].slots[slotIndex].effect) trackSource(bucketIndex, slotIndex);
+            }
+        }
+    }
+    
+    // ===== DESHACER =====
+    void setJournal(GameJournal* gameJournal) { journal = gameJournal; }
+
+    void undo(const GameJournal::Entry& entry) {
+        if (entry.op == GameJournal::Op::EXPIRY_ADD) {
+            expiryWheel[entry.small].pop_back();
+            return;
+        }
+        if (entry.op == GameJournal::Op::SUBSCRIBE) {
+            applyWatched(entry.small, entry.index, entry.value);
+            return;
+        }
+        if (entry.op == GameJournal::Op::EXPIRY_REMOVE) {
+            auto& pending = expiryWheel[entry.small];
+            pending.insert(pending.begin() + entry.index,
+                           Expiry{static_cast<uint32_t>(entry.value >> 32), static_cast<EffectHandle>(entry.value)});
+            return;
+        }
+        Bucket& bucket = buckets[entry.small];
+        Slot& slot = bucket.slots[entry.index];
+        if (entry.op == GameJournal::Op::EFFECT_ADD) {
+            if (slot.watched) unlink(entry.small, entry.index, slot.watched);
+            untrackSource(entry.small, entry.index);
+            slot.effect = nullptr;
+            --bucket.live;
+            if (entry.value) bucket.freeSlots.push_back(static_cast<uint16_t>(entry.index));
+            else bucket.slots.pop_back();
+        } else if (entry.op == GameJournal::Op::EFFECT_ERASE) {
+            // El slot es el último liberado: vuelve con su generación anterior
+            bucket.freeSlots.pop_back();
+            slot.generation = previousGeneration(slot.generation);
+            slot.effect = entry.effect;
+            trackSource(entry.small, entry.index);
+            if (slot.watched) link(entry.small, entry.index, slot.watched);
+            ++bucket.live;
+        }
     }
     
     // Limpiar todos los efectos
     void clear() {
-        for (auto& list : effectsByTrigger) {
-            list.clear();
+        for (Bucket& bucket : buckets) {
+            bucket.slots.clear();
+            bucket.freeSlots.clear();
+            bucket.live = 0;
+        }
+        for (auto& slot : expiryWheel) slot.clear();
+        for (CellSubscribers& lists : subscribers) {
+            for (auto& list : lists) list.clear();
         }
-        effectPointers.clear();
-        nextEffectId = 1;
+        sourceSlots.clear();
     }
 };
@@ -12,34 +12,35 @@
 class AttackModifierEffectImpl : public EffectImpl {
 private:
     int attackChange;
+    bool persistent;  // Aura hasta que la fuente deje el mapa o el efecto expire (duration != 0)
 
 public:
-    AttackModifierEffectImpl(CardPtr src, PlayerId ownerId, int change)
-        : EffectImpl(src, ownerId, change > 0 ? "AttackBuff" : "AttackDebuff"), 
-          attackChange(change) {}
+    AttackModifierEffectImpl(CardPtr src, PlayerId ownerId, int change, bool aura = false)
+        : EffectImpl(src, ownerId, change > 0 ? "AttackBuff"_sym : "AttackDebuff"_sym), 
+          attackChange(change), persistent(aura) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
-        for (auto cell : targetCells) {
-            if (cell && cell->card.has_value()) {
-                auto card = cell->card.value();
-                if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
-                    int newAttack = std::max(0, static_cast<int>(unit->getAttack()) + attackChange);
-                    unit->setAttack(newAttack);
-                }
-            }
-        }
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
+        if (persistent && applyAura(gameMap, &UnitStatStore::attack, targetCells, attackChange)) return;
+        gameMap.getUnitStats().addAttack(gameMap.selectUnits(targetCells), attackChange);
+    }
+    
+    void expire(GameMap& gameMap) override {
+        if (persistent) removeAura(gameMap, &UnitStatStore::attack);
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (Unit* unit = Card::as<Unit>(card)) {
                 int newAttack = std::max(0, static_cast<int>(unit->getAttack()) + attackChange);
                 unit->setAttack(newAttack);
+                refreshCard(gameMap, *unit);
             }
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que modifica la salud de cartas
@@ -49,37 +50,29 @@ private:
 
 public:
     HealthModifierEffectImpl(CardPtr src, PlayerId ownerId, int change)
-        : EffectImpl(src, ownerId, change > 0 ? "HealthBuff" : "HealthDebuff"), 
+        : EffectImpl(src, ownerId, change > 0 ? "HealthBuff"_sym : "HealthDebuff"_sym), 
           healthChange(change) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
-        for (auto cell : targetCells) {
-            if (cell && cell->card.has_value()) {
-                auto card = cell->card.value();
-                if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
-                    if (healthChange > 0) {
-                        unit->heal(healthChange);
-                    } else {
-                        unit->takeDamage(-healthChange);
-                    }
-                }
-            }
-        }
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
+        gameMap.getUnitStats().addHealth(gameMap.selectUnits(targetCells), healthChange);
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (Unit* unit = Card::as<Unit>(card)) {
                 if (healthChange > 0) {
                     unit->heal(healthChange);
                 } else {
                     unit->takeDamage(-healthChange);
                 }
+                refreshCard(gameMap, *unit);
             }
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que hace daño directo
@@ -89,28 +82,24 @@ private:
 
 public:
     DamageEffectImpl(CardPtr src, PlayerId ownerId, uint8_t damage)
-        : EffectImpl(src, ownerId, "Damage"), damageAmount(damage) {}
+        : EffectImpl(src, ownerId, "Damage"_sym), damageAmount(damage) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
-        for (auto cell : targetCells) {
-            if (cell && cell->card.has_value()) {
-                auto card = cell->card.value();
-                if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
-                    unit->takeDamage(damageAmount);
-                }
-            }
-        }
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
+        gameMap.getUnitStats().addHealth(gameMap.selectUnits(targetCells), -static_cast<int>(damageAmount));
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (Unit* unit = Card::as<Unit>(card)) {
                 unit->takeDamage(damageAmount);
+                refreshCard(gameMap, *unit);
             }
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que cura cartas
@@ -120,96 +109,94 @@ private:
 
 public:
     HealEffectImpl(CardPtr src, PlayerId ownerId, uint8_t heal)
-        : EffectImpl(src, ownerId, "Heal"), healAmount(heal) {}
+        : EffectImpl(src, ownerId, "Heal"_sym), healAmount(heal) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
-        for (auto cell : targetCells) {
-            if (cell && cell->card.has_value()) {
-                auto card = cell->card.value();
-                if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
-                    unit->heal(healAmount);
-                }
-            }
-        }
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
+        gameMap.getUnitStats().addHealth(gameMap.selectUnits(targetCells), healAmount);
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (Unit* unit = Card::as<Unit>(card)) {
                 unit->heal(healAmount);
+                refreshCard(gameMap, *unit);
             }
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que modifica el alcance de cartas
 class RangeModifierEffectImpl : public EffectImpl {
 private:
     int rangeChange;
+    bool persistent;  // Aura hasta que la fuente deje el mapa o el efecto expire (duration != 0)
 
 public:
-    RangeModifierEffectImpl(CardPtr src, PlayerId ownerId, int change)
-        : EffectImpl(src, ownerId, change > 0 ? "RangeBuff" : "RangeDebuff"), 
-          rangeChange(change) {}
+    RangeModifierEffectImpl(CardPtr src, PlayerId ownerId, int change, bool aura = false)
+        : EffectImpl(src, ownerId, change > 0 ? "RangeBuff"_sym : "RangeDebuff"_sym), 
+          rangeChange(change), persistent(aura) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
-        for (auto cell : targetCells) {
-            if (cell && cell->card.has_value()) {
-                auto card = cell->card.value();
-                if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
-                    int newRange = std::max(1, static_cast<int>(unit->getRange()) + rangeChange);
-                    unit->setRange(newRange);
-                }
-            }
-        }
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
+        if (persistent && applyAura(gameMap, &UnitStatStore::range, targetCells, rangeChange)) return;
+        gameMap.getUnitStats().addRange(gameMap.selectUnits(targetCells), rangeChange);
+    }
+    
+    void expire(GameMap& gameMap) override {
+        if (persistent) removeAura(gameMap, &UnitStatStore::range);
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (Unit* unit = Card::as<Unit>(card)) {
                 int newRange = std::max(1, static_cast<int>(unit->getRange()) + rangeChange);
                 unit->setRange(newRange);
+                refreshCard(gameMap, *unit);
             }
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que modifica la velocidad de cartas
 class SpeedModifierEffectImpl : public EffectImpl {
 private:
     int speedChange;
+    bool persistent;  // Aura hasta que la fuente deje el mapa o el efecto expire (duration != 0)
 
 public:
-    SpeedModifierEffectImpl(CardPtr src, PlayerId ownerId, int change)
-        : EffectImpl(src, ownerId, change > 0 ? "SpeedBuff" : "SpeedDebuff"), 
-          speedChange(change) {}
+    SpeedModifierEffectImpl(CardPtr src, PlayerId ownerId, int change, bool aura = false)
+        : EffectImpl(src, ownerId, change > 0 ? "SpeedBuff"_sym : "SpeedDebuff"_sym), 
+          speedChange(change), persistent(aura) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
-        for (auto cell : targetCells) {
-            if (cell && cell->card.has_value()) {
-                auto card = cell->card.value();
-                if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
-                    int newSpeed = std::max(1, static_cast<int>(unit->getSpeed()) + speedChange);
-                    unit->setSpeed(newSpeed);
-                }
-            }
-        }
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
+        if (persistent && applyAura(gameMap, &UnitStatStore::speed, targetCells, speedChange)) return;
+        gameMap.getUnitStats().addSpeed(gameMap.selectUnits(targetCells), speedChange);
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void expire(GameMap& gameMap) override {
+        if (persistent) removeAura(gameMap, &UnitStatStore::speed);
+    }
+    
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (Unit* unit = Card::as<Unit>(card)) {
                 int newSpeed = std::max(1, static_cast<int>(unit->getSpeed()) + speedChange);
                 unit->setSpeed(newSpeed);
+                refreshCard(gameMap, *unit);
             }
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que modifica el costo de cartas
@@ -219,22 +206,27 @@ private:
 
 public:
     CostModifierEffectImpl(CardPtr src, PlayerId ownerId, int change)
-        : EffectImpl(src, ownerId, change > 0 ? "CostIncrease" : "CostReduction"), 
+        : EffectImpl(src, ownerId, change > 0 ? "CostIncrease"_sym : "CostReduction"_sym), 
           costChange(change) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
         // Este efecto normalmente se aplicaría a cartas en la mano, no en el mapa
         // Pero por completitud, permitimos que funcione
         (void)gameMap; (void)triggerCell; (void)targetCells;
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
+            if (GameJournal* journal = gameMap.getJournal()) {
+                journal->record({.op = GameJournal::Op::COST, .value = card->getCost(), .card = card});
+            }
             int newCost = std::max(0, static_cast<int>(card->getCost()) + costChange);
             card->setCost(newCost);
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // ================================
@@ -248,10 +240,10 @@ private:
 
 public:
     DrawCardsEffectImpl(CardPtr src, PlayerId ownerId, uint8_t count)
-        : EffectImpl(src, ownerId, "DrawCards"), cardCount(count) {}
+        : EffectImpl(src, ownerId, "DrawCards"_sym), cardCount(count) {}
     
     // Este efecto no afecta celdas específicas
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
         // No hace nada - necesita acceso al GameState
         (void)gameMap; (void)triggerCell; (void)targetCells;
     }
@@ -260,6 +252,8 @@ public:
         // DrawCard functionality disabled - no access to private drawCard method
         (void)gameMap; (void)triggerCell; (void)gameState;
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que agrega maná
@@ -269,9 +263,9 @@ private:
 
 public:
     AddManaEffectImpl(CardPtr src, PlayerId ownerId, uint8_t mana)
-        : EffectImpl(src, ownerId, "AddMana"), manaAmount(mana) {}
+        : EffectImpl(src, ownerId, "AddMana"_sym), manaAmount(mana) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
         // No hace nada - necesita acceso al GameState
         (void)gameMap; (void)triggerCell; (void)targetCells;
     }
@@ -280,6 +274,8 @@ public:
         // Sistema no usa mana, solo acciones - efecto deshabilitado
         (void)gameMap; (void)triggerCell; (void)gameState;
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que reduce el costo de cartas en la mano
@@ -289,9 +285,9 @@ private:
 
 public:
     ReduceHandCostEffectImpl(CardPtr src, PlayerId ownerId, uint8_t reduction)
-        : EffectImpl(src, ownerId, "ReduceHandCost"), costReduction(reduction) {}
+        : EffectImpl(src, ownerId, "ReduceHandCost"_sym), costReduction(reduction) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
         // No hace nada - necesita acceso al GameState
         (void)gameMap; (void)triggerCell; (void)targetCells;
     }
@@ -300,6 +296,8 @@ public:
         // Sistema no maneja costos de mano de esta manera - efecto deshabilitado
         (void)gameMap; (void)triggerCell; (void)gameState;
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // ================================
@@ -313,15 +311,15 @@ private:
 
 public:
     PrintEffectImpl(CardPtr src, PlayerId ownerId, const std::string& msg) 
-        : EffectImpl(src, ownerId, "Print"), message(msg) {}
+        : EffectImpl(src, ownerId, "Print"_sym), message(msg) {}
 
     // Solo implementa QUÉ hacer: imprimir un mensaje
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
         (void)gameMap; (void)triggerCell; (void)targetCells;
         std::println("[DEBUG] {}: {}", source ? source->getName() : "Unknown", message);
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
         (void)gameMap; (void)triggerCell; (void)targetCards;
         std::println("[DEBUG] {}: {}", source ? source->getName() : "Unknown", message);
     }
@@ -330,34 +328,40 @@ public:
         (void)gameMap; (void)triggerCell; (void)gameState;
         std::println("[DEBUG] {}: {}", source ? source->getName() : "Unknown", message);
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Efecto que destruye/elimina cartas
 class DestroyEffectImpl : public EffectImpl {
 public:
     DestroyEffectImpl(CardPtr src, PlayerId ownerId)
-        : EffectImpl(src, ownerId, "Destroy") {}
+        : EffectImpl(src, ownerId, "Destroy"_sym) {}
     
-    void apply(GameMap& gameMap, MapCell* triggerCell, const std::list<MapCell*>& targetCells) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void apply(GameMap& gameMap, MapCell* triggerCell, const CellList& targetCells) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto cell : targetCells) {
-            if (cell && cell->card.has_value()) {
-                auto card = cell->card.value();
-                if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (cell && cell->hasCard()) {
+                const CardPtr& card = gameMap.getCard(cell);
+                if (Unit* unit = Card::as<Unit>(card)) {
                     // Marcar como muerto (el GameState se encargará de la limpieza)
                     unit->takeDamage(unit->getHealth());
+                    gameMap.refreshUnit(cell);
                 }
             }
         }
     }
     
-    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const std::list<CardPtr>& targetCards) override {
-        (void)gameMap; (void)triggerCell; // Suprimir warnings de parámetros no usados
+    void applyToCards(GameMap& gameMap, MapCell* triggerCell, const CardList& targetCards) override {
+        (void)triggerCell; // Suprimir warnings de parámetros no usados
         for (auto card : targetCards) {
-            if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+            if (Unit* unit = Card::as<Unit>(card)) {
                 // Marcar como muerto
                 unit->takeDamage(unit->getHealth());
+                refreshCard(gameMap, *unit);
             }
         }
     }
+    
+    EffectImplPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
@@ -0,0 +1,62 @@
+#pragma once
+#include <cassert>
+#include <memory>
+#include "../../libs/flat_hash_map.hpp"
+#include "../cards/Card.hpp"
+#include "../effects/Effect.hpp"
+#include "../utils/GameArena.hpp"
+
+// Tabla de correspondencias de una copia profunda (GameState::clone).
+// Cada carta y cada efecto de la partida original se copia una sola vez y
+// todas las referencias a él (mapa, manos, mazos, pila de efectos, fuentes de
+// triggers y selectores) pasan a apuntar a la misma copia. Las copias se
+// reservan en la arena activa (GameArena::Scope de la partida destino).
+class CloneContext {
+    private:
+        ska::flat_hash_map<const Card*, CardPtr> cards;
+        ska::flat_hash_map<const Effect*, EffectPtr> effects;
+        const GameArena* target = nullptr;
+
+    public:
+        CloneContext() = default;
+
+        // Reserva para copiar una partida entera sin rehashes (unas decenas de entradas)
+        explicit CloneContext(size_t expectedEntries) {
+            cards.reserve(expectedEntries);
+            effects.reserve(expectedEntries);
+        }
+
+        // Arena de la partida destino: en depuración, cada copia comprueba que
+        // se reserva en ella y no en la de la original (ver GameArena)
+        void setTarget(const GameArena& arena) { target = &arena; }
+
+        // Copia de una carta de la partida original (la misma copia en cada llamada)
+        CardPtr card(const CardPtr& original) {
+            if (!original) return nullptr;
+            auto found = cards.find(original.get());
+            if (found != cards.end()) return found->second;
+            assert((!target || target->isCurrent()) && "clone fuera de la arena de la partida destino");
+
+            CardPtr copy = original->clone();
+            // Se registra antes de copiar los efectos: rompe el ciclo carta -> efecto -> carta
+            cards.emplace(original.get(), copy);
+            for (EffectPtr& effect : copy->effects) effect = this->effect(effect);
+            return copy;
+        }
+
+        template<typename T>
+        std::shared_ptr<T> card(const std::shared_ptr<T>& original) {
+            return std::static_pointer_cast<T>(card(CardPtr(original)));
+        }
+
+        // Copia de un efecto (la misma copia en cada llamada)
+        EffectPtr effect(const EffectPtr& original) {
+            if (!original) return nullptr;
+            assert((!target || target->isCurrent()) && "clone fuera de la arena de la partida destino");
+            auto found = effects.find(original.get());
+            return found != effects.end() ? found->second : original->clone(*this);
+        }
+
+        // Effect::clone registra su copia antes de copiar la carta fuente
+        void record(const Effect* original, EffectPtr copy) { effects.emplace(original, std::move(copy)); }
+};
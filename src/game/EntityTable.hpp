@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "../utils/Types.hpp"
+
+// Tabla de entidades de una partida: las celdas del mapa guardan un handle de
+// 16 bits (EntityId) y la tabla es la única dueña del CardPtr correspondiente.
+// Los handles liberados se reutilizan; NO_ENTITY (0) nunca se asigna.
+class EntityTable {
+    private:
+        std::vector<CardPtr> slots;        // slots[id - 1]
+        std::vector<EntityId> freeList;    // Handles liberados para reutilizar
+
+        static inline const CardPtr EMPTY = nullptr;
+
+    public:
+        EntityId add(CardPtr card) {
+            if (!freeList.empty()) {
+                EntityId id = freeList.back();
+                freeList.pop_back();
+                slots[id - 1] = std::move(card);
+                return id;
+            }
+            slots.push_back(std::move(card));
+            return static_cast<EntityId>(slots.size());
+        }
+
+        // Libera el handle y devuelve la carta que contenía
+        CardPtr remove(EntityId id) {
+            if (id == NO_ENTITY || id > slots.size()) return nullptr;
+            CardPtr card = std::move(slots[id - 1]);
+            slots[id - 1] = nullptr;
+            freeList.push_back(id);
+            return card;
+        }
+
+        const CardPtr& get(EntityId id) const {
+            return id == NO_ENTITY || id > slots.size() ? EMPTY : slots[id - 1];
+        }
+
+        size_t size() const { return slots.size() - freeList.size(); }
+
+        // add() reutilizará un handle liberado
+        bool hasFreeHandle() const { return !freeList.empty(); }
+
+        // Inversa exacta de add(): handle y lista libre quedan como antes
+        void undoAdd(EntityId id, bool reused) {
+            if (reused) {
+                slots[id - 1] = nullptr;
+                freeList.push_back(id);
+            } else {
+                slots.pop_back();
+            }
+        }
+
+        // Inversa exacta de remove(): el handle vuelve a su carta
+        void undoRemove(EntityId id, CardPtr card) {
+            freeList.pop_back();
+            slots[id - 1] = std::move(card);
+        }
+
+        // Sustituye cada carta por remap(carta) conservando los handles (copias de partida)
+        template<typename Remap>
+        void remapCards(Remap&& remap) {
+            for (CardPtr& slot : slots) {
+                if (slot) slot = remap(slot);
+            }
+        }
+};
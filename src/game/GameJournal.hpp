@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../utils/Types.hpp"
+
+class Trigger;
+
+// Registro de deshacer de una partida (make/unmake para búsqueda). Cada
+// mutación añade la información mínima para invertirla; GameState::undo()
+// recorre las entradas en orden inverso y cada componente (GameMap,
+// UnitStatStore, EffectStack, GameState) deshace las suyas.
+// Los vectores conservan su capacidad al deshacer: tras unas pocas jugadas
+// registrar y deshacer no reserva memoria.
+class GameJournal {
+    public:
+        enum class Op : uint8_t {
+            // GameMap
+            PLACE,          // index = celda, small = 1 si el handle se reutilizó
+            REMOVE,         // index = celda, entity, card, value = hash de la celda
+            MOVE,           // index = origen, small = destino, value = hash del origen
+            REHASH,         // index = celda, value = hash anterior de la celda
+            // UnitStatStore
+            STAT,           // small = columna, index = slot, value = valor anterior
+            MODIFIER_ADD,   // index = posición del modificador añadido
+            MODIFIER_REMOVE,// index = posición, value = modificador empaquetado
+            // Cartas
+            COST,           // card, value = coste anterior
+            OWNER,          // card, value = dueño anterior
+            POSITION,       // card, index = celda anterior (NO_CELL si no estaba en el mapa)
+            TRIGGER_STATE,  // trigger, value = estado anterior
+            // EffectStack
+            EFFECT_ADD,     // small = cubo, index = slot, value = 1 si el slot estaba libre
+            EFFECT_ERASE,   // small = cubo, index = slot, effect
+            EXPIRY_ADD,     // small = ranura de la rueda
+            EXPIRY_REMOVE,  // small = ranura, index = posición, value = turno << 32 | handle
+            SUBSCRIBE,      // small = cubo, index = slot, value = celdas suscritas anteriores
+            // Listas de cartas de los jugadores
+            LIST_PUSH,      // list
+            LIST_POP,       // list, card
+            LIST_ERASE,     // list, index = posición, card
+            LIST_INSERT,    // list, index = posición
+            LIST_SNAPSHOT,  // list, index = inicio en savedCards, value = número de cartas
+            LEGEND          // small = jugador, card = leyenda anterior
+        };
+
+        struct Entry {
+            Op op;
+            uint8_t small = 0;
+            EntityId entity = NO_ENTITY;
+            uint32_t index = 0;
+            uint64_t value = 0;
+            std::vector<CardPtr>* list = nullptr;
+            // Los triggers viven mientras su efecto exista, y el efecto lo
+            // mantiene vivo su carta o una entrada EFFECT_ERASE
+            Trigger* trigger = nullptr;
+            CardPtr card = nullptr;
+            EffectPtr effect = nullptr;
+        };
+
+    private:
+        std::vector<Entry> entries;
+        // Contenido de las listas guardadas con LIST_SNAPSHOT (apilado como las entradas)
+        std::vector<CardPtr> savedCards;
+
+    public:
+        static constexpr size_t INITIAL_ENTRIES = 256;
+
+        GameJournal() { entries.reserve(INITIAL_ENTRIES); }
+
+        void record(Entry entry) { entries.push_back(std::move(entry)); }
+
+        // Guarda la lista entera (barajados, descarte -> mazo)
+        void recordSnapshot(std::vector<CardPtr>& list) {
+            record({.op = Op::LIST_SNAPSHOT, .index = static_cast<uint32_t>(savedCards.size()),
+                    .value = list.size(), .list = &list});
+            savedCards.insert(savedCards.end(), list.begin(), list.end());
+        }
+
+        size_t size() const { return entries.size(); }
+        bool empty() const { return entries.empty(); }
+        Entry& back() { return entries.back(); }
+
+        void pop() {
+            if (entries.back().op == Op::LIST_SNAPSHOT) savedCards.resize(entries.back().index);
+            entries.pop_back();
+        }
+
+        // Restaura una lista guardada con recordSnapshot (entrada en la cima)
+        void restoreSnapshot(const Entry& entry) {
+            entry.list->assign(savedCards.begin() + entry.index, savedCards.begin() + entry.index + entry.value);
+        }
+
+        void clear() {
+            entries.clear();
+            savedCards.clear();
+        }
+};
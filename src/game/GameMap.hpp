@@ -5,9 +5,18 @@
 #include <optional>
 #include <numeric>
 #include <string>
+#include <print>
+#include <bit>
+#include <algorithm>
+#include <span>
 #include "MapCell.hpp"  // Include completo en lugar de forward declaration
+#include "MapGeometry.hpp"
+#include "EntityTable.hpp"
+#include "UnitStatStore.hpp"
+#include "../cards/Card.hpp" // Definición completa de Unit (hash y máscara de leyendas)
 #include "../utils/StrColors.hpp" // Necesario para el operador string()
 #include "../utils/Types.hpp"
+#include "../utils/Zobrist.hpp"
 
 class GameMap {
 
@@ -22,16 +31,8 @@ class GameMap {
         };
         
         // Invierte la dirección para el jugador 1 (reflejo vertical)
-        static Adjacency invertDirection(Adjacency direction) {
-            static constexpr std::array<Adjacency, 6> INVERTED_DIRECTIONS = {
-                Adjacency::DOWN,         // UP -> DOWN
-                Adjacency::BOTTOM_RIGHT, // TOP_RIGHT -> BOTTOM_RIGHT
-                Adjacency::TOP_RIGHT,    // BOTTOM_RIGHT -> TOP_RIGHT
-                Adjacency::UP,           // DOWN -> UP
-                Adjacency::TOP_LEFT,     // BOTTOM_LEFT -> TOP_LEFT
-                Adjacency::BOTTOM_LEFT   // TOP_LEFT -> BOTTOM_LEFT
-            };
-            return INVERTED_DIRECTIONS[static_cast<uint8_t>(direction)];
+        static constexpr Adjacency invertDirection(Adjacency direction) {
+            return static_cast<Adjacency>(MapGeometryDetail::INVERTED_DIRECTIONS[static_cast<uint8_t>(direction)]);
         }
         
         static const std::string getAdjacencyName(Adjacency direction) {
@@ -41,94 +42,484 @@ class GameMap {
             return ADJACENCY_NAMES[static_cast<uint8_t>(direction)];
         };
 
+        // Tablero por defecto (5x7); otros tamaños se eligen con map_width / map_height
         static const constexpr uint8_t 
             MAP_HEIGHT = 7,
             MAP_WIDTH = 5;
 
+        // Tablas de vecindad precalculadas para el tablero por defecto
+        using Geometry = MapGeometry<MAP_WIDTH, MAP_HEIGHT>;
+
+        // Máximo de celdas de cualquier geometría soportada (un bit por celda)
+        static constexpr uint8_t MAX_CELLS = 64;
+
     private:
-        std::array<std::array<MapCell, MAP_WIDTH>, MAP_HEIGHT> mapData;
+        // Geometría precompilada elegida en la construcción
+        const MapLayout* layout;
+        // Celdas en orden fila-mayor: índice = y * ancho + x
+        std::array<MapCell, MAX_CELLS> mapData;
+        // Dueña de las cartas colocadas; las celdas solo guardan su EntityId
+        EntityTable entities;
+        // Estadísticas de las unidades colocadas, indexadas por el mismo handle
+        UnitStatStore unitStats;
 
-        static inline const auto& MAP_DEFAULT_TEMPLATE = [](){
-            std::array<std::array<MapCell, MAP_WIDTH>, MAP_HEIGHT> mapDataTemplate;
+        // Bitboards (bit i = celda i) sincronizados con placeCard/removeCard/moveCard
+        std::array<uint64_t, 2> occupancy{}; // Celdas ocupadas por cada jugador
+        uint64_t legends = 0;                // Celdas ocupadas por leyendas
 
-            static constexpr auto isWalkable = [](uint8_t x, uint8_t y) -> bool { 
-                return (y >= 3 && y < MAP_HEIGHT - 1) || 
-                    x == MAP_WIDTH / 2 ||
-                    (y == 2 && x >= 1 && x < MAP_WIDTH - 1) ;
-            };
-            
-            static constexpr auto isSpawn = [](uint8_t x, uint8_t y) -> bool {
-                return (x == 2 && y == 0) || (x == 2 && y == 6); // Spawn positions
-            };
+        // Hash Zobrist del tablero: XOR de la clave de cada celda ocupada.
+        // Se guarda la clave vigente de cada celda para poder retirarla aunque
+        // las estadísticas de la unidad ya hayan cambiado
+        uint64_t boardHash = 0;
+        std::array<uint64_t, MAX_CELLS> cellHashes{};
 
-            using namespace std::ranges;
-    
-            for (const auto [x, y] : views::iota(0, MAP_WIDTH * MAP_HEIGHT) 
-                | views::transform([](uint8_t i) { return std::pair{i % MAP_WIDTH, i / MAP_WIDTH}; })) {
+        // Registro de deshacer de la partida (nullptr si no se registra)
+        GameJournal* journal = nullptr;
+
+        uint64_t unitHash(CellIndex index, EntityId entity) const {
+            const CardPtr& card = entities.get(entity);
+            const uint64_t stats = unitStats.isUnit(entity) ? unitStats.packed(entity) : 0;
+            return Zobrist::key(Zobrist::Domain::UNIT, index, uint64_t{card->getId()} | uint64_t{card->getOwner()} << 8, stats);
+        }
+
+        static constexpr uint64_t bitOf(CellIndex index) { return uint64_t{1} << index; }
+
+        void applyFloorTemplate() {
+            for (CellIndex index = 0; index < layout->cellCount; ++index) {
+                const uint64_t bit = uint64_t{1} << index;
                 MapCell::FloorType floorType;
-                if (isSpawn(x, y)) {
+                if (layout->spawnMask & bit) {
                     floorType = MapCell::FloorType::SPAWN;
-                } else if (isWalkable(x, y)) {
+                } else if (layout->walkableMask & bit) {
                     floorType = MapCell::FloorType::WALKABLE;
                 } else {
                     floorType = MapCell::FloorType::NONE;
                 }
-                mapDataTemplate[y][x] = MapCell(floorType);
+                mapData[index] = MapCell(floorType);
             }
-            
-            return mapDataTemplate;
-        }();
+        }
 
     public:
 
-        GameMap() : mapData(MAP_DEFAULT_TEMPLATE) {}
-        
-        MapCell* getNeighbor(Adjacency direction, const MapCell* cell, PlayerId playerId = 0) {
-            if (!cell) return nullptr;
+        GameMap() : GameMap(MAP_WIDTH, MAP_HEIGHT) {}
 
-            // Invertir dirección para el jugador 1
-            if (playerId == 1) {
-                direction = invertDirection(direction);
+        // Selecciona una de las geometrías precompiladas; si las dimensiones no
+        // están soportadas se usa el tablero por defecto
+        GameMap(uint8_t width, uint8_t height) : layout(findMapLayout(width, height)) {
+            if (!layout) {
+                std::println("Warning: Mapa {}x{} no soportado, usando {}x{}", width, height, MAP_WIDTH, MAP_HEIGHT);
+                layout = &Geometry::LAYOUT;
             }
+            applyFloorTemplate();
+        }
 
-            auto [cellX, cellY] = getCellCoordinates(cell);
-            if (cellX == 255) return nullptr; // Cell not found
+        // Las unidades colocadas apuntan a unitStats: el mapa no se copia ni se mueve
+        GameMap(const GameMap&) = delete;
+        GameMap& operator=(const GameMap&) = delete;
 
-            static constexpr std::array positionTransformation = {
-                std::pair{0, -1}, // UP
-                std::pair{1,  0}, // TOP_RIGHT
-                std::pair{1,  1}, // BOTTOM_RIGHT
-                std::pair{0,  1}, // DOWN
-                std::pair{-1, 1}, // BOTTOM_LEFT
-                std::pair{-1, 0}  // TOP_LEFT
-            };
+        // Devuelve las estadísticas a las unidades que siguen vivas fuera del mapa
+        ~GameMap() {
+            forEachCell(getOccupiedMask(), [&](CellIndex index) {
+                if (Unit* unit = Card::as<Unit>(getCard(index))) unit->detachStats();
+            });
+        }
+
+        // Convierte este mapa (recién construido y vacío) en una copia exacta de
+        // other: mismas celdas, handles, estadísticas y hash. Las cartas pasan
+        // por remapCard, que devuelve su copia en la partida destino
+        template<typename RemapCard>
+        void cloneFrom(const GameMap& other, RemapCard&& remapCard) {
+            layout = other.layout;
+            mapData = other.mapData;
+            entities = other.entities;
+            entities.remapCards(remapCard);
+            unitStats = other.unitStats;
+            unitStats.journal = journal;
+            occupancy = other.occupancy;
+            legends = other.legends;
+            boardHash = other.boardHash;
+            cellHashes = other.cellHashes;
+            // Las copias de las unidades salen fuera del almacén: se vuelven a
+            // enganchar con las mismas estadísticas y el mismo handle
+            forEachCell(getOccupiedMask(), [&](CellIndex index) {
+                if (Unit* unit = Card::as<Unit>(getCard(index))) unit->attachStats(unitStats, at(index)->entity);
+            });
+        }
+
+        static bool isSupportedSize(uint8_t width, uint8_t height) {
+            return findMapLayout(width, height) != nullptr;
+        }
+
+        const MapLayout& getLayout() const { return *layout; }
+
+        // ===== MUTACIONES (mantienen los bitboards) =====
+        // Toda escritura de MapCell::entity debe pasar por aquí
+
+        // Coloca una carta en una celda con suelo y vacía; el dueño de la carta
+        // debe estar asignado antes de colocarla
+        bool placeCard(CellIndex index, const CardPtr& card) {
+            MapCell* cell = at(index);
+            if (!cell || !card || cell->floor == MapCell::FloorType::NONE || cell->hasCard()) return false;
+            const bool reused = entities.hasFreeHandle();
+            cell->entity = entities.add(card);
+            if (journal) journal->record({.op = GameJournal::Op::PLACE, .small = reused, .index = index});
+            if (Unit* unit = Card::as<Unit>(card)) unit->attachStats(unitStats, cell->entity);
+            occupancy[card->getOwner() & 1] |= bitOf(index);
+            if (card->isLegend()) legends |= bitOf(index);
+            cellHashes[index] = unitHash(index, cell->entity);
+            boardHash ^= cellHashes[index];
+            return true;
+        }
+
+        // Retira la carta de una celda y la devuelve (nullptr si estaba vacía)
+        CardPtr removeCard(CellIndex index) {
+            MapCell* cell = at(index);
+            if (!cell || !cell->hasCard()) return nullptr;
+            if (journal) {
+                journal->record({.op = GameJournal::Op::REMOVE, .entity = cell->entity, .index = index,
+                                 .value = cellHashes[index], .card = entities.get(cell->entity)});
+            }
+            const uint64_t affected = unitStats.dropModifiers(cell->entity) & ~(uint64_t{1} << UnitStatStore::slotOf(cell->entity));
+            if (Unit* unit = Card::as<Unit>(entities.get(cell->entity))) unit->detachStats();
+            CardPtr card = entities.remove(cell->entity);
+            cell->entity = NO_ENTITY;
+            occupancy[0] &= ~bitOf(index);
+            occupancy[1] &= ~bitOf(index);
+            legends &= ~bitOf(index);
+            boardHash ^= cellHashes[index];
+            cellHashes[index] = 0;
+            // Las unidades que recibían sus auras cambian de estadísticas
+            refreshSlots(affected);
+            return card;
+        }
+
+        // Debe llamarse tras modificar las estadísticas de la unidad de una celda
+        void refreshUnit(CellIndex index) {
+            const MapCell* cell = at(index);
+            if (!cell || !cell->hasCard()) return;
+            const uint64_t updated = unitHash(index, cell->entity);
+            if (journal) journal->record({.op = GameJournal::Op::REHASH, .index = index, .value = cellHashes[index]});
+            boardHash ^= cellHashes[index] ^ updated;
+            cellHashes[index] = updated;
+        }
+
+        void refreshUnit(const MapCell* cell) { refreshUnit(indexOf(cell)); }
+
+        // refreshUnit de la celda de una entidad (no-op si no es una unidad del mapa)
+        void refreshEntity(EntityId id) {
+            if (unitStats.isUnit(id)) refreshSlots(uint64_t{1} << UnitStatStore::slotOf(id));
+        }
+
+        // refreshUnit en las celdas de las unidades de unos slots de UnitStatStore
+        void refreshSlots(uint64_t slots) {
+            if (!slots) return;
+            forEachCell(getOccupiedMask(), [&](CellIndex index) {
+                const EntityId entity = at(index)->entity;
+                if ((slots >> UnitStatStore::slotOf(entity)) & 1u) refreshUnit(index);
+            });
+        }
+
+        uint64_t getBoardHash() const { return boardHash; }
+
+        // Recalcula el hash del tablero desde cero (para validar el incremental)
+        uint64_t computeBoardHash() const {
+            uint64_t hash = 0;
+            forEachCell(getOccupiedMask(), [&](CellIndex index) { hash ^= unitHash(index, at(index)->entity); });
+            return hash;
+        }
+
+        // El handle de la entidad se conserva: solo cambia de celda
+        bool moveCard(CellIndex from, CellIndex to) {
+            MapCell* source = at(from);
+            MapCell* target = at(to);
+            if (!source || !source->hasCard() || !target ||
+                target->floor == MapCell::FloorType::NONE || target->hasCard()) return false;
+            if (journal) journal->record({.op = GameJournal::Op::MOVE, .small = to, .index = from, .value = cellHashes[from]});
+            const uint64_t owner = (occupancy[1] >> from) & 1u;
+            const uint64_t legend = (legends >> from) & 1u;
+
+            target->entity = source->entity;
+            source->entity = NO_ENTITY;
+            occupancy[owner] = (occupancy[owner] & ~bitOf(from)) | bitOf(to);
+            legends = (legends & ~bitOf(from)) | (legend << to);
+
+            boardHash ^= cellHashes[from];
+            cellHashes[from] = 0;
+            cellHashes[to] = unitHash(to, target->entity);
+            boardHash ^= cellHashes[to];
+            return true;
+        }
+
+        // ===== DESHACER =====
+        // El mapa registra sus propias mutaciones (y las de unitStats) mientras
+        // haya un registro asignado
+        void setJournal(GameJournal* gameJournal) {
+            journal = gameJournal;
+            unitStats.journal = gameJournal;
+        }
+
+        GameJournal* getJournal() const { return journal; }
+
+        // Invierte una entrada registrada por el mapa, dejando handles, bitboards
+        // y hashes exactamente como estaban
+        void undo(const GameJournal::Entry& entry) {
+            const CellIndex index = static_cast<CellIndex>(entry.index);
+            MapCell* cell = at(index);
+            switch (entry.op) {
+                case GameJournal::Op::PLACE: {
+                    if (Unit* unit = Card::as<Unit>(entities.get(cell->entity))) unit->detachStats();
+                    entities.undoAdd(cell->entity, entry.small);
+                    cell->entity = NO_ENTITY;
+                    occupancy[0] &= ~bitOf(index);
+                    occupancy[1] &= ~bitOf(index);
+                    legends &= ~bitOf(index);
+                    boardHash ^= cellHashes[index];
+                    cellHashes[index] = 0;
+                    break;
+                }
+                case GameJournal::Op::REMOVE: {
+                    entities.undoRemove(entry.entity, entry.card);
+                    cell->entity = entry.entity;
+                    if (Unit* unit = Card::as<Unit>(entry.card)) unit->attachStats(unitStats, entry.entity);
+                    occupancy[entry.card->getOwner() & 1] |= bitOf(index);
+                    if (entry.card->isLegend()) legends |= bitOf(index);
+                    cellHashes[index] = entry.value;
+                    boardHash ^= entry.value;
+                    break;
+                }
+                case GameJournal::Op::MOVE: {
+                    const CellIndex to = entry.small;
+                    MapCell* target = at(to);
+                    const uint64_t owner = (occupancy[1] >> to) & 1u;
+                    const uint64_t legend = (legends >> to) & 1u;
+                    cell->entity = target->entity;
+                    target->entity = NO_ENTITY;
+                    occupancy[owner] = (occupancy[owner] & ~bitOf(to)) | bitOf(index);
+                    legends = (legends & ~bitOf(to)) | (legend << index);
+                    boardHash ^= cellHashes[to] ^ entry.value;
+                    cellHashes[to] = 0;
+                    cellHashes[index] = entry.value;
+                    break;
+                }
+                case GameJournal::Op::REHASH:
+                    boardHash ^= cellHashes[index] ^ entry.value;
+                    cellHashes[index] = entry.value;
+                    break;
+                case GameJournal::Op::STAT:
+                case GameJournal::Op::MODIFIER_ADD:
+                case GameJournal::Op::MODIFIER_REMOVE:
+                    unitStats.undo(entry);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Carta de una celda (nullptr si está vacía o fuera del mapa)
+        const CardPtr& getCard(CellIndex index) const {
+            const MapCell* cell = at(index);
+            return entities.get(cell ? cell->entity : NO_ENTITY);
+        }
+
+        const CardPtr& getCard(const MapCell* cell) const {
+            return entities.get(cell ? cell->entity : NO_ENTITY);
+        }
 
-            auto& [dx, dy] = positionTransformation[static_cast<uint8_t>(direction)];
-            auto neighbor_x = dx + cellX, neighbor_y = dy + cellY;
+        const CardPtr& getEntity(EntityId id) const { return entities.get(id); }
 
-            return neighbor_x >= MAP_WIDTH || neighbor_y >= MAP_HEIGHT ? 
-                nullptr :
-                &mapData[neighbor_y][neighbor_x];
+        // Columnas de estadísticas de las unidades colocadas. Tras modificarlas
+        // hay que llamar a refreshUnit en cada celda afectada
+        UnitStatStore& getUnitStats() { return unitStats; }
+        const UnitStatStore& getUnitStats() const { return unitStats; }
+
+        // Selección de slots para los kernels de UnitStatStore: marca las
+        // unidades de las celdas dadas (se ignoran vacías y hechizos)
+        template<typename Cells>
+        UnitStatStore::Selection selectUnits(const Cells& cells) const {
+            UnitStatStore::Selection selection{};
+            for (const MapCell* cell : cells) {
+                if (cell && unitStats.isUnit(cell->entity)) selection[UnitStatStore::slotOf(cell->entity)] = 1;
+            }
+            return selection;
+        }
+
+        // ===== MODIFICADORES (auras) =====
+        // Capa de modificadores de UnitStatStore con el hash de las celdas
+        // afectadas al día. Las auras de una unidad se quitan solas cuando deja
+        // el mapa (removeCard)
+
+        void addModifier(UnitStatStore::AuraKey key, EntityId source, CellIndex target, UnitStatStore::Column column, int delta) {
+            const MapCell* cell = at(target);
+            if (!cell) return;
+            unitStats.addModifier(key, source, cell->entity, column, delta);
+            refreshUnit(target);
+        }
+
+        void removeModifiers(UnitStatStore::AuraKey key, UnitStatStore::Column column = nullptr) {
+            refreshSlots(unitStats.removeModifiers(key, column));
+        }
+
+        // Sustituye el aura del efecto key sobre una estadística por un
+        // modificador en cada unidad de las celdas dadas. Los valores base no
+        // cambian, y reevaluar un aura persistente con los mismos objetivos no
+        // toca nada. Las auras de otros efectos de la misma fuente se conservan
+        template<typename Cells>
+        void setAura(UnitStatStore::AuraKey key, EntityId source, UnitStatStore::Column column, const Cells& cells, int delta) {
+            uint64_t targets = 0;
+            for (const MapCell* cell : cells) {
+                if (cell && unitStats.isUnit(cell->entity)) targets |= uint64_t{1} << UnitStatStore::slotOf(cell->entity);
+            }
+            if (unitStats.hasAura(key, column, delta ? targets : 0, delta)) return;
+
+            const uint64_t affected = unitStats.removeModifiers(key, column) | targets;
+            for (uint64_t pending = targets; pending; pending &= pending - 1) {
+                unitStats.addModifier(key, source, UnitStatStore::entityOf(static_cast<size_t>(std::countr_zero(pending))), column, delta);
+            }
+            refreshSlots(affected);
+        }
+
+        // ===== CONSULTAS SOBRE BITBOARDS =====
+        uint64_t getWalkableMask() const { return layout->walkableMask; }
+        uint64_t getSpawnMask() const { return layout->spawnMask; }
+        uint64_t getOccupancyMask(PlayerId playerId) const { return occupancy[playerId & 1]; }
+        uint64_t getOccupiedMask() const { return occupancy[0] | occupancy[1]; }
+        uint64_t getLegendMask() const { return legends; }
+        uint64_t getEmptyMask() const { return layout->walkableMask & ~getOccupiedMask(); }
+        uint64_t getEnemyMask(PlayerId playerId) const { return occupancy[(playerId & 1) ^ 1]; }
+        uint64_t getTerritoryMask(PlayerId playerId) const { return layout->territoryMasks[playerId & 1]; }
+        uint64_t getNeighborMask(CellIndex cell, PlayerId playerId = 0) const {
+            return (*layout->adjacency)[MapGeometryDetail::orientationOf(playerId)][cell];
+        }
+
+        // Distancia en pasos entre dos celdas (UNREACHABLE si alguna no existe)
+        uint8_t getDistance(CellIndex from, CellIndex to) const {
+            if (from >= layout->cellCount || to >= layout->cellCount) return MapGeometryDetail::UNREACHABLE;
+            return (*layout->distances)[from][to];
+        }
+
+        // Celdas a distancia 1..range de cell (range se recorta a MAX_RANGE)
+        uint64_t getRangeMask(CellIndex cell, uint8_t range) const {
+            if (cell >= layout->cellCount) return 0;
+            return (*layout->rangeMasks)[cell][std::min(range, MapGeometryDetail::MAX_RANGE)];
+        }
+
+        // Celdas enemigas al alcance de una unidad del jugador situada en cell
+        uint64_t getAttackMask(CellIndex cell, uint8_t range, PlayerId playerId) const {
+            return getRangeMask(cell, range) & getEnemyMask(playerId);
+        }
+
+        // Celdas alcanzables desde origin en como máximo speed pasos, atravesando
+        // solo celdas caminables y vacías (BFS por capas sobre bitboards)
+        uint64_t getReachableMask(CellIndex origin, uint8_t speed, PlayerId playerId = 0) const {
+            if (origin >= layout->cellCount) return 0;
+            const uint64_t passable = getEmptyMask();
+            uint64_t reachable = 0;
+            uint64_t frontier = bitOf(origin);
+            for (uint8_t step = 0; step < speed && frontier; ++step) {
+                uint64_t next = 0;
+                forEachCell(frontier, [&](CellIndex cell) { next |= getNeighborMask(cell, playerId); });
+                frontier = next & passable & ~reachable & ~bitOf(origin);
+                reachable |= frontier;
+            }
+            return reachable;
+        }
+
+        // Celdas en línea recta desde cell (sin incluirla) hasta el borde, en orden
+        std::span<const CellIndex> getRay(Adjacency direction, CellIndex cell, PlayerId playerId = 0) const {
+            if (cell >= layout->cellCount) return {};
+            const auto& ray = (*layout->rays)[MapGeometryDetail::orientationOf(playerId)][cell][static_cast<uint8_t>(direction)];
+            return {ray.cells.data(), ray.length};
+        }
+
+        // Primera celda ocupada del rayo (NO_CELL si la línea está libre hasta el borde)
+        CellIndex getFirstBlocker(Adjacency direction, CellIndex cell, PlayerId playerId = 0) const {
+            const uint64_t occupied = getOccupiedMask();
+            for (CellIndex next : getRay(direction, cell, playerId)) {
+                if ((occupied >> next) & 1u) return next;
+            }
+            return NO_CELL;
+        }
+
+        // Celda de la leyenda del jugador (NO_CELL si no está en el mapa)
+        CellIndex getLegendCell(PlayerId playerId) const {
+            const uint64_t mask = legends & occupancy[playerId & 1];
+            return mask ? static_cast<CellIndex>(std::countr_zero(mask)) : NO_CELL;
+        }
+
+        // Celdas donde el jugador puede invocar: vacías y adyacentes a su leyenda
+        uint64_t getPlacementMask(PlayerId playerId) const {
+            const CellIndex legendCell = getLegendCell(playerId);
+            return legendCell == NO_CELL ? 0 : getEmptyMask() & getNeighborMask(legendCell, playerId);
+        }
+
+        bool isEmpty(CellIndex index) const { return index < layout->cellCount && (getEmptyMask() & bitOf(index)); }
+        bool isWalkable(CellIndex index) const { return index < layout->cellCount && (layout->walkableMask & bitOf(index)); }
+
+        // Recorre los índices de los bits activos de una máscara
+        template <typename F>
+        static void forEachCell(uint64_t mask, F&& f) {
+            while (mask) {
+                f(static_cast<CellIndex>(std::countr_zero(mask)));
+                mask &= mask - 1;
+            }
+        }
+
+        // Conversión handle <-> coordenadas solo con aritmética
+        CellIndex toIndex(uint8_t x, uint8_t y) const {
+            return x >= layout->width || y >= layout->height ? NO_CELL : static_cast<CellIndex>(y * layout->width + x);
+        }
+
+        std::pair<uint8_t, uint8_t> toCoordinates(CellIndex index) const {
+            return index >= layout->cellCount ?
+                std::pair<uint8_t, uint8_t>{255, 255} :
+                std::pair<uint8_t, uint8_t>{index % layout->width, index / layout->width};
+        }
+
+        // Handle de una celda del mapa (las celdas están contiguas en mapData)
+        CellIndex indexOf(const MapCell* cell) const {
+            if (!cell) return NO_CELL;
+            const MapCell* first = mapData.data();
+            if (cell < first || cell >= first + layout->cellCount) return NO_CELL;
+            return static_cast<CellIndex>(cell - first);
+        }
+
+        // Vecino en una dirección (relativa al jugador): una sola lectura de tabla
+        CellIndex getNeighbor(Adjacency direction, CellIndex cell, PlayerId playerId = 0) const {
+            return (*layout->neighbors)[MapGeometryDetail::orientationOf(playerId)][cell][static_cast<uint8_t>(direction)];
+        }
+
+        // Verifica si candidate es vecina de cell sin recorrer las 6 direcciones
+        bool isNeighbor(CellIndex cell, CellIndex candidate, PlayerId playerId = 0) const {
+            return candidate < layout->cellCount &&
+                   (((*layout->adjacency)[MapGeometryDetail::orientationOf(playerId)][cell] >> candidate) & 1u);
+        }
+
+        MapCell* getNeighbor(Adjacency direction, const MapCell* cell, PlayerId playerId = 0) {
+            return at(getNeighbor(direction, indexOf(cell), playerId));
+        }
+
+        inline MapCell* at(CellIndex index) {
+            return index >= layout->cellCount ? nullptr : &mapData[index];
+        }
+
+        inline const MapCell* at(CellIndex index) const {
+            return index >= layout->cellCount ? nullptr : &mapData[index];
         }
 
         inline MapCell* at(uint8_t x, uint8_t y) {
-            return x >= MAP_WIDTH || y >= MAP_HEIGHT  ?  
-                nullptr : // Out of bounds
-                &mapData[y][x];
+            return at(toIndex(x, y)); // NO_CELL fuera de límites -> nullptr
         }
 
         inline const MapCell* at(uint8_t x, uint8_t y) const {
-            return x >= MAP_WIDTH || y >= MAP_HEIGHT  ?  
-                nullptr : // Out of bounds
-                &mapData[y][x];
+            return at(toIndex(x, y));
         }
 
         operator std::string() const {
             std::string result;
-            result.reserve(MAP_HEIGHT * (MAP_WIDTH * 6 + 1));
+            result.reserve(layout->height * (layout->width * 6 + 1));
             
-            for (const auto& row : mapData) {
-                for (const auto& cell : row) result += " " + std::string(cell) + " ";
+            for (uint8_t y = 0; y < layout->height; ++y) {
+                for (uint8_t x = 0; x < layout->width; ++x) result += " " + at(x, y)->render((legends >> toIndex(x, y)) & 1u) + " ";
                 result += '\n';
             }
             using namespace StrColors;
@@ -143,15 +534,15 @@ class GameMap {
         }
     
         // Dimension accessors
-        constexpr uint8_t getWidth() const { return MAP_WIDTH; }
-        constexpr uint8_t getHeight() const { return MAP_HEIGHT; }
+        uint8_t getWidth() const { return layout->width; }
+        uint8_t getHeight() const { return layout->height; }
+        uint8_t getCellCount() const { return layout->cellCount; }
         
         // Helper para encontrar posiciones de spawn
         std::pair<uint8_t, uint8_t> getSpawnPosition(PlayerId playerId) const {
-            // Player 0 spawn en (2,0), Player 1 spawn en (2,6)
-            if (playerId == 0) return {2, 0};
-            if (playerId == 1) return {2, 6};
-            return {255, 255}; // Invalid position for other players
+            // Centro de la primera fila (jugador 0) y de la última (jugador 1)
+            if (playerId > 1) return {255, 255}; // Invalid position for other players
+            return toCoordinates(layout->spawnCells[playerId]);
         }
         
         bool isSpawnPosition(uint8_t x, uint8_t y) const {
@@ -161,16 +552,7 @@ class GameMap {
     
         // Helper to find coordinates of a cell in the map
         std::pair<uint8_t, uint8_t> getCellCoordinates(const MapCell* cell) const {
-            if (!cell) return {255, 255};
-            
-            for (uint8_t y = 0; y < MAP_HEIGHT; ++y) {
-                for (uint8_t x = 0; x < MAP_WIDTH; ++x) {
-                    if (&mapData[y][x] == cell) {
-                        return {x, y};
-                    }
-                }
-            }
-            return {255, 255}; // Not found
+            return toCoordinates(indexOf(cell));
         }
 
 };
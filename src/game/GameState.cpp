@@ -38,8 +38,18 @@ GameState::GameState() :
     }
 }
 
+GameState::GameState(EmptyPlayers players) : GameState() {
+    for (uint8_t i = 0; i < players.count; ++i) {
+        PlayerId id = i + 1;
+        Team team = (i & 1) ? Team::TEAM_B : Team::TEAM_A;
+        std::string name = "Player " + std::to_string(id);
+        
+        addPlayer(id, team, name);
+    }
+}
+
 GameState::GameState(const GameConfig& config) : 
-    map(), // Create default map
+    map(config.getUInt8("map_width", GameMap::MAP_WIDTH), config.getUInt8("map_height", GameMap::MAP_HEIGHT)),
     effectStack(),
     gameConfig(config) {
     // Initialize with default values
@@ -55,9 +65,233 @@ GameState::GameState(const GameConfig& config) :
 }
 
 GameState::GameState(std::vector<CardPtr> deck1, std::vector<CardPtr> deck2, const GameConfig& config) :
-    map(),
+    map(config.getUInt8("map_width", GameMap::MAP_WIDTH), config.getUInt8("map_height", GameMap::MAP_HEIGHT)),
+    effectStack(),
+    gameConfig(config) {
+    setupPlayers(std::move(deck1), std::move(deck2));
+}
+
+GameState::GameState(const DeckBuilder& buildDeck, const GameConfig& config) :
+    map(config.getUInt8("map_width", GameMap::MAP_WIDTH), config.getUInt8("map_height", GameMap::MAP_HEIGHT)),
     effectStack(),
     gameConfig(config) {
+    std::vector<CardPtr> deck1, deck2;
+    {
+        GameArena::Scope scope(arena);
+        deck1 = buildDeck(0);
+        deck2 = buildDeck(1);
+    }
+    setupPlayers(std::move(deck1), std::move(deck2));
+}
+
+GameState::GameState(const GameState& source, CloneContext& context) :
+    map(source.map.getWidth(), source.map.getHeight()),
+    effectStack(),
+    gameConfig(source.gameConfig),
+    currentPlayer(source.currentPlayer),
+    turnNumber(source.turnNumber),
+    phase(source.phase),
+    handHashes(source.handHashes) {
+    GameArena::Scope scope(arena);
+    context.setTarget(arena);
+    const auto remapCards = [&](const std::vector<CardPtr>& cards) {
+        std::vector<CardPtr> copies;
+        copies.reserve(cards.size());
+        for (const CardPtr& card : cards) copies.push_back(context.card(card));
+        return copies;
+    };
+    
+    map.cloneFrom(source.map, [&](const CardPtr& card) { return context.card(card); });
+    
+    players.reserve(source.players.size());
+    for (const Player& player : source.players) {
+        Player& copy = players.emplace_back(player.id, player.team, player.name);
+        copy.health = player.health;
+        copy.actionsRemaining = player.actionsRemaining;
+        copy.maxActionsPerTurn = player.maxActionsPerTurn;
+        copy.maxHandSize = player.maxHandSize;
+        copy.deck = remapCards(player.deck);
+        copy.hand = remapCards(player.hand);
+        copy.discard = remapCards(player.discard);
+        copy.legend = context.card(player.legend);
+    }
+    
+    effectStack.cloneFrom(source.effectStack, context);
+    
+    // Every card on the map is indexed; the reachability cache starts cold
+    GameMap::forEachCell(map.getOccupiedMask(), [&](CellIndex index) {
+        cardPositions[map.getCard(index).get()] = index;
+    });
+}
+
+GameStatePtr GameState::clone() const {
+    CloneContext context(CLONE_RESERVE);
+    return GameStatePtr(new GameState(*this, context));
+}
+
+GameState::~GameState() {
+    // Cards hold their effects and every effect component holds its source
+    // card. Once the cards drop their effects, the members release the rest
+    // and each object frees what it keeps on the global heap
+    effectStack.clear();
+    const auto clearEffects = [](const std::vector<CardPtr>& cards) {
+        for (const CardPtr& card : cards) card->clearEffects();
+    };
+    for (Player& player : players) {
+        clearEffects(player.deck);
+        clearEffects(player.hand);
+        clearEffects(player.discard);
+        if (player.legend) player.legend->clearEffects();
+    }
+    GameMap::forEachCell(map.getOccupiedMask(), [&](CellIndex index) { map.getCard(index)->clearEffects(); });
+}
+
+GameState::ActionScope::ActionScope(GameState& gameState) : game(gameState) {
+    if (game.actionDepth++ > 0 || !game.journaling) {
+        return;
+    }
+    game.undoFrames.push_back({game.journal.size(), game.playerSnapshots.size(), rng_state,
+                               game.turnNumber, game.currentPlayer, game.phase, game.handHashes});
+    for (const Player& player : game.players) {
+        game.playerSnapshots.push_back({player.health, player.actionsRemaining,
+                                        player.maxActionsPerTurn, player.maxHandSize});
+    }
+}
+
+void GameState::enableJournal(bool enabled) {
+    journaling = enabled;
+    GameJournal* active = enabled ? &journal : nullptr;
+    map.setJournal(active);
+    effectStack.setJournal(active);
+    if (!enabled) {
+        journal.clear();
+        undoFrames.clear();
+        playerSnapshots.clear();
+    }
+}
+
+void GameState::undo(size_t count) {
+    for (; count > 0 && !undoFrames.empty(); --count) {
+        const UndoFrame& frame = undoFrames.back();
+        while (journal.size() > frame.firstEntry) {
+            undoEntry(journal.back());
+            journal.pop();
+        }
+        
+        rng_state = frame.rngState;
+        turnNumber = frame.turnNumber;
+        currentPlayer = frame.currentPlayer;
+        phase = frame.phase;
+        handHashes = frame.handHashes;
+        for (size_t i = 0; i < players.size(); ++i) {
+            const PlayerSnapshot& snapshot = playerSnapshots[frame.firstPlayer + i];
+            players[i].health = snapshot.health;
+            players[i].actionsRemaining = snapshot.actionsRemaining;
+            players[i].maxActionsPerTurn = snapshot.maxActionsPerTurn;
+            players[i].maxHandSize = snapshot.maxHandSize;
+        }
+        playerSnapshots.resize(frame.firstPlayer);
+        undoFrames.pop_back();
+    }
+}
+
+void GameState::undoEntry(const GameJournal::Entry& entry) {
+    using Op = GameJournal::Op;
+    switch (entry.op) {
+        case Op::PLACE:
+        case Op::REMOVE:
+        case Op::MOVE:
+        case Op::REHASH:
+        case Op::STAT:
+        case Op::MODIFIER_ADD:
+        case Op::MODIFIER_REMOVE:
+            map.undo(entry);
+            break;
+        case Op::EFFECT_ADD:
+        case Op::EFFECT_ERASE:
+        case Op::EXPIRY_ADD:
+        case Op::EXPIRY_REMOVE:
+        case Op::SUBSCRIBE:
+            effectStack.undo(entry);
+            break;
+        case Op::COST:
+            entry.card->setCost(static_cast<uint8_t>(entry.value));
+            break;
+        case Op::OWNER:
+            entry.card->setOwner(static_cast<PlayerId>(entry.value));
+            break;
+        case Op::POSITION: {
+            Unit* unit = Card::as<Unit>(entry.card);
+            const CellIndex previous = static_cast<CellIndex>(entry.index);
+            if (previous == NO_CELL) {
+                cardPositions.erase(entry.card.get());
+                if (unit) unit->removeFromMap();
+            } else {
+                cardPositions[entry.card.get()] = previous;
+                auto [x, y] = map.toCoordinates(previous);
+                if (unit) unit->setPosition(x, y);
+            }
+            break;
+        }
+        case Op::TRIGGER_STATE:
+            entry.trigger->setState(entry.value);
+            break;
+        case Op::LIST_PUSH:
+            entry.list->pop_back();
+            break;
+        case Op::LIST_POP:
+            entry.list->push_back(entry.card);
+            break;
+        case Op::LIST_ERASE:
+            entry.list->insert(entry.list->begin() + entry.index, entry.card);
+            break;
+        case Op::LIST_INSERT:
+            entry.list->erase(entry.list->begin() + entry.index);
+            break;
+        case Op::LIST_SNAPSHOT:
+            journal.restoreSnapshot(entry);
+            break;
+        case Op::LEGEND:
+            players[entry.small].legend = std::static_pointer_cast<Legend>(entry.card);
+            break;
+    }
+}
+
+void GameState::pushCard(std::vector<CardPtr>& list, CardPtr card) {
+    if (journaling) journal.record({.op = GameJournal::Op::LIST_PUSH, .list = &list});
+    list.push_back(std::move(card));
+}
+
+CardPtr GameState::popCard(std::vector<CardPtr>& list) {
+    CardPtr card = std::move(list.back());
+    list.pop_back();
+    if (journaling) journal.record({.op = GameJournal::Op::LIST_POP, .list = &list, .card = card});
+    return card;
+}
+
+void GameState::eraseCard(std::vector<CardPtr>& list, size_t index) {
+    if (journaling) {
+        journal.record({.op = GameJournal::Op::LIST_ERASE, .index = static_cast<uint32_t>(index),
+                        .list = &list, .card = list[index]});
+    }
+    list.erase(list.begin() + index);
+}
+
+void GameState::insertCard(std::vector<CardPtr>& list, size_t index, CardPtr card) {
+    if (journaling) journal.record({.op = GameJournal::Op::LIST_INSERT, .index = static_cast<uint32_t>(index), .list = &list});
+    list.insert(list.begin() + index, std::move(card));
+}
+
+void GameState::saveList(std::vector<CardPtr>& list) {
+    if (journaling) journal.recordSnapshot(list);
+}
+
+void GameState::setCardOwner(const CardPtr& card, PlayerId owner) {
+    if (journaling) journal.record({.op = GameJournal::Op::OWNER, .value = card->getOwner(), .card = card});
+    card->setOwner(owner);
+}
+
+void GameState::setupPlayers(std::vector<CardPtr> deck1, std::vector<CardPtr> deck2) {
     // Initialize with default values
     phase = GamePhase::SETUP;
     turnNumber = 0;
@@ -127,7 +361,10 @@ void GameState::drawCard(Player& player, uint8_t count) {
         if (player.deck.empty()) {
             // Reshuffle discard pile into deck if needed
             if (!player.discard.empty()) {
+                saveList(player.deck);
+                saveList(player.discard);
                 player.deck = std::move(player.discard);
+                player.discard.clear();
                 shuffleContainer(player.deck);
             } else {
                 // No cards left to draw
@@ -136,8 +373,8 @@ void GameState::drawCard(Player& player, uint8_t count) {
         }
         
         if (!player.deck.empty()) {
-            player.hand.push_back(player.deck.back());
-            player.deck.pop_back();
+            pushCard(player.hand, popCard(player.deck));
+            handHashes[player.id & 1] += handCardHash(player.id, player.hand.back());
         }
     }
 }
@@ -149,12 +386,13 @@ void GameState::returnCardToDeck(PlayerId playerId, CardPtr card) {
     }
     
     // Las leyendas NUNCA vuelven al mazo - son únicas
-    if (auto legend = std::dynamic_pointer_cast<Legend>(card)) {
-        std::println("⚠️  Advertencia: Intentando devolver leyenda {} al mazo - las leyendas no se reciclan", legend->getName());
+    if (card->isLegend()) {
+        std::println("⚠️  Advertencia: Intentando devolver leyenda {} al mazo - las leyendas no se reciclan", card->getName());
         return;
     }
     
     // Agregar la carta al mazo
+    saveList(player->deck);
     player->deck.push_back(card);
     
     // Barajar el mazo para que la carta aparezca en una posición aleatoria
@@ -164,11 +402,16 @@ void GameState::returnCardToDeck(PlayerId playerId, CardPtr card) {
 }
 
 void GameState::endTurn(PlayerId playerId) {
+    ActionScope journaled(*this);
     if (playerId != currentPlayer) {
         std::println("Not your turn!");
         return;
     }
     
+    // Effects whose duration ends this turn leave the stack (timing wheel: only
+    // the effects due now are visited, however long the game gets)
+    effectStack.expireTurn(elapsedTurns(), map);
+    
     // Reset current player's actions for next turn
     resetPlayerActions(currentPlayer);
     
@@ -191,6 +434,19 @@ void GameState::endTurn(PlayerId playerId) {
     }
 }
 
+void GameState::stackEffect(const EffectPtr& effect) {
+    // One registration per trigger bucket; each one expires on its own (expire is idempotent)
+    const EffectHandles handles = effectStack.addTriggeredEffect(effect, map);
+    if (effect->getDuration() < 0) return;
+    for (EffectHandle handle : handles) {
+        effectStack.scheduleExpiry(handle, elapsedTurns() + static_cast<uint32_t>(effect->getDuration()));
+    }
+}
+
+uint32_t GameState::elapsedTurns() const {
+    return turnNumber * static_cast<uint32_t>(players.size()) + currentPlayer;
+}
+
 void GameState::applyConfigurationToPlayers() {
     uint8_t maxHandSize = gameConfig.getUInt8("max_hand_size", 7);
     uint8_t maxActions = gameConfig.getUInt8("max_actions_per_turn", 3);
@@ -205,6 +461,7 @@ void GameState::applyConfigurationToPlayers() {
 }
 
 bool GameState::processAction(const GameAction& action) {
+    ActionScope journaled(*this);
     if (action.playerId != currentPlayer) {
         std::println("Not your turn!");
         return false;
@@ -249,6 +506,7 @@ bool GameState::processAction(const GameAction& action) {
 }
 
 void GameState::playCard(PlayerId playerId, CardPtr card, uint8_t x, uint8_t y) {
+    ActionScope journaled(*this);
     // Use simple player lookup
     Player* player = findPlayer(playerId);
     if (!player) {
@@ -264,71 +522,62 @@ void GameState::playCard(PlayerId playerId, CardPtr card, uint8_t x, uint8_t y)
     }
 
     // Verificar que no sea una leyenda - las leyendas no se pueden jugar desde la mano
-    if (auto legend = std::dynamic_pointer_cast<Legend>(card)) {
-        std::println("❌ Error: Las leyendas no se pueden jugar desde la mano. La leyenda {} ya debería estar en el mapa.", legend->getName());
+    if (card->isLegend()) {
+        std::println("❌ Error: Las leyendas no se pueden jugar desde la mano. La leyenda {} ya debería estar en el mapa.", card->getName());
         return;
     }
 
     // Remove from hand first (efficient removal by index)
-    player->hand.erase(player->hand.begin() + cardIndex);
+    eraseCard(player->hand, cardIndex);
 
     // Handle different card types
-    if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+    if (card->isUnit()) {
         // For units: place on the map
-        MapCell* cell = map.at(x, y);
-        if (!cell || cell->card.has_value() || cell->floor == MapCell::FloorType::NONE) {
+        if (!map.isEmpty(map.toIndex(x, y))) {
             std::println("Invalid target position for unit! Position ({}, {}) is not walkable or occupied", x, y);
             // Return card to hand if placement failed
-            player->hand.insert(player->hand.begin() + cardIndex, card);
+            insertCard(player->hand, cardIndex, card);
             return;
         }
         
         // Para unidades, verificar adyacencia al líder
         if (!player->legend || !player->legend->isOnMap()) {
             std::println("❌ Error: No se puede colocar unidades sin un líder en el mapa.");
-            player->hand.insert(player->hand.begin() + cardIndex, card);
+            insertCard(player->hand, cardIndex, card);
             return;
         }
         
-        auto legend = std::dynamic_pointer_cast<Unit>(player->legend);
+        const Legend* legend = player->legend.get();
         if (!legend) {
             std::println("❌ Error: Problema con el líder del jugador.");
-            player->hand.insert(player->hand.begin() + cardIndex, card);
+            insertCard(player->hand, cardIndex, card);
             return;
         }
         
         auto [leaderX, leaderY] = legend->getCoordinates();
-        MapCell* leaderCell = map.at(leaderX, leaderY);
         
-        bool isAdjacent = false;
-        // Verificar todas las direcciones de adyacencia
-        for (int i = 0; i < 6; ++i) {
-            GameMap::Adjacency adj = static_cast<GameMap::Adjacency>(i);
-            MapCell* adjacentCell = map.getNeighbor(adj, leaderCell, playerId);
-            if (adjacentCell && adjacentCell == cell) {
-                isAdjacent = true;
-                break;
-            }
-        }
-        
-        if (!isAdjacent) {
+        // Verificar adyacencia con la máscara precalculada del líder
+        if (!map.isNeighbor(map.toIndex(leaderX, leaderY), map.toIndex(x, y), playerId)) {
             std::println("❌ Error: Las unidades solo pueden colocarse adyacentes al líder del jugador.");
-            player->hand.insert(player->hand.begin() + cardIndex, card);
+            insertCard(player->hand, cardIndex, card);
             return;
         }
 
         // Set owner and place the unit on the map
-        card->setOwner(playerId);
-        cell->card = card;
+        setCardOwner(card, playerId);
+        map.placeCard(map.toIndex(x, y), card);
+        indexCardPosition(card, x, y);
+        // Enter effects watching the cell see the new unit
+        effectStack.processPositionEnter(map, map.at(x, y), this);
         std::println("Unit {} played at position ({}, {})", card->getName(), x, y);
 
-    } else if (auto spell = std::dynamic_pointer_cast<Spell>(card)) {
+    } else if (card->isSpell()) {
         // For spells: cast immediately and return to deck
         std::println("Spell {} cast", card->getName());
 
         // Process the spell's effects immediately
         for (const auto& effect : card->getEffects()) {
-            effectStack.addEffect(effect);
+            stackEffect(effect);
         }
 
         // Return spell to deck after casting
@@ -337,42 +586,34 @@ void GameState::playCard(PlayerId playerId, CardPtr card, uint8_t x, uint8_t y)
     } else {
         std::println("Unknown card type for {}", card->getName());
         // Return card to hand if unknown type
-        player->hand.insert(player->hand.begin() + cardIndex, card);
+        insertCard(player->hand, cardIndex, card);
         return;
     }
     
     // Process remaining effects (for units)
-    if (auto unit = std::dynamic_pointer_cast<Unit>(card)) {
+    if (card->isUnit()) {
         for (const auto& effect : card->getEffects()) {
-            effectStack.addEffect(effect);
+            stackEffect(effect);
         }
     }
     
+    // The card has left the hand for good (failed plays return earlier with the card reinserted)
+    handHashes[playerId & 1] -= handCardHash(playerId, card);
+    
     // Consume action after successful play
     consumeAction(playerId);
 }
 
 // Placeholder implementations for remaining methods
 bool GameState::moveCard(PlayerId playerId, CardPtr card, uint8_t x, uint8_t y) {
+    ActionScope journaled(*this);
     // Find current position of the card
-    uint8_t fromX = 255, fromY = 255; // Invalid positions as default
-    
-    for (uint8_t mapY = 0; mapY < map.getHeight(); ++mapY) {
-        for (uint8_t mapX = 0; mapX < map.getWidth(); ++mapX) {
-            MapCell* cell = map.at(mapX, mapY);
-            if (cell && cell->card.has_value() && cell->card.value() == card) {
-                fromX = mapX;
-                fromY = mapY;
-                break;
-            }
-        }
-        if (fromX != 255) break;
-    }
-    
-    if (fromX == 255) {
-        std::println("Card {} not found on map!", card->getName());
+    auto position = getCardPosition(card);
+    if (!position) {
+        std::println("Card {} not found on map!", card ? card->getName() : "null");
         return false;
     }
+    auto [fromX, fromY] = *position;
     
     // Validate movement
     if (!canMoveCard(playerId, card, fromX, fromY, x, y)) {
@@ -382,11 +623,13 @@ bool GameState::moveCard(PlayerId playerId, CardPtr card, uint8_t x, uint8_t y)
     }
     
     // Perform the move
-    MapCell* fromCell = map.at(fromX, fromY);
-    MapCell* toCell = map.at(x, y);
-    
-    toCell->card = card;
-    fromCell->card.reset();
+    map.moveCard(map.toIndex(fromX, fromY), map.toIndex(x, y));
+    indexCardPosition(card, x, y);
+    // Its enter/exit effects now watch the cells around the new position
+    effectStack.refreshSubscriptions(card, map);
+    // Then the effects watching either cell see it leave one and enter the other
+    effectStack.processPositionExit(map, map.at(fromX, fromY), this);
+    effectStack.processPositionEnter(map, map.at(x, y), this);
     // Consume action after successful move
     consumeAction(playerId);
     std::println("Moved card {} from ({}, {}) to ({}, {})", 
@@ -395,6 +638,7 @@ bool GameState::moveCard(PlayerId playerId, CardPtr card, uint8_t x, uint8_t y)
 }
 
 bool GameState::attackWithCard(PlayerId playerId, CardPtr card, uint8_t targetX, uint8_t targetY) {
+    ActionScope journaled(*this);
     // Validate attack using improved validation
     if (!canAttack(playerId, card, targetX, targetY)) {
         std::println("Invalid attack by player {} with card {}", playerId, card ? card->getName() : "null");
@@ -403,7 +647,7 @@ bool GameState::attackWithCard(PlayerId playerId, CardPtr card, uint8_t targetX,
     
     // Get target
     MapCell* targetCell = map.at(targetX, targetY);
-    CardPtr target = targetCell->card.value();
+    CardPtr target = map.getCard(targetCell);
     
     // Simple combat: destroy target (placeholder - you'd want actual stats)
     std::println("Player {} attacks with {} targeting {} at position ({}, {})", 
@@ -454,43 +698,23 @@ bool GameState::canAttack(PlayerId playerId, CardPtr attacker, uint8_t targetX,
         return false;
     }
     
-    // Check if attacking card is on the map
-    bool attackerOnMap = false;
-    for (uint8_t y = 0; y < map.getHeight() && !attackerOnMap; ++y) {
-        for (uint8_t x = 0; x < map.getWidth() && !attackerOnMap; ++x) {
-            const MapCell* cell = map.at(x, y);
-            if (cell && cell->card.has_value() && cell->card.value() == attacker) {
-                attackerOnMap = true;
-                break;
-            }
-        }
-    }
-    
-    if (!attackerOnMap) {
+    // Only units attack, and only from the map
+    const Unit* unit = Card::as<Unit>(attacker);
+    auto it = cardPositions.find(attacker.get());
+    if (!unit || it == cardPositions.end()) {
         return false;
     }
     
-    // Check if target position is valid
-    if (!isValidPosition(targetX, targetY)) {
+    // Target must be an enemy card within the attacker's range (precomputed mask)
+    const CellIndex target = map.toIndex(targetX, targetY);
+    if (target == NO_CELL) {
         return false;
     }
-    
-    // Check if there's something to attack at target position
-    const MapCell* targetCell = map.at(targetX, targetY);
-    if (!targetCell || !targetCell->card.has_value()) {
-        return false;
-    }
-    
-    // Can't attack own cards
-    CardPtr target = targetCell->card.value();
-    if (target->getOwner() == playerId) {
-        return false;
-    }
-    
-    return true;
+    return (map.getAttackMask(it->second, unit->getRange(), playerId) >> target) & 1u;
 }
 
 void GameState::dealDamage(PlayerId targetPlayer, uint8_t damage) {
+    ActionScope journaled(*this);
     Player* player = findPlayer(targetPlayer);
     if (player) {
         if (damage >= player->health) {
@@ -503,71 +727,148 @@ void GameState::dealDamage(PlayerId targetPlayer, uint8_t damage) {
 }
 
 void GameState::destroyCard(CardPtr card) {
+    ActionScope journaled(*this);
     if (!card) return;
     
     // Find the card on the map and remove it
-    for (uint8_t y = 0; y < map.getHeight(); ++y) {
-        for (uint8_t x = 0; x < map.getWidth(); ++x) {
-            MapCell* cell = map.at(x, y);
-            if (cell && cell->card.has_value() && cell->card.value() == card) {
-                // Return card to owner's deck (except legends)
-                Player* owner = findPlayer(card->getOwner());
-                if (owner) {
-                    // Si es una leyenda, manejar especialmente
-                    if (auto legend = std::dynamic_pointer_cast<Legend>(card)) {
-                        if (owner->legend == legend) {
-                            owner->legend = nullptr;
-                            std::println("¡Leyenda {} destruida! Jugador {} eliminado!", 
-                                       legend->getName(), owner->id);
-                            
-                            // Las leyendas destruidas NO regresan al mazo (son únicas)
-                            owner->discard.push_back(card);
-                        }
-                    } else {
-                        // Cartas normales regresan al mazo para ser reutilizadas
-                        returnCardToDeck(owner->id, card);
-                    }
+    auto position = getCardPosition(card);
+    if (!position) return;
+    
+    // Return card to owner's deck (except legends)
+    Player* owner = findPlayer(card->getOwner());
+    if (owner) {
+        // Si es una leyenda, manejar especialmente
+        if (card->isLegend()) {
+            if (owner->legend.get() == card.get()) {
+                if (journaling) {
+                    journal.record({.op = GameJournal::Op::LEGEND,
+                                    .small = static_cast<uint8_t>(owner - players.data()), .card = owner->legend});
                 }
-                cell->card.reset();
-                std::println("Card {} destroyed", card->getName());
+                owner->legend = nullptr;
+                std::println("¡Leyenda {} destruida! Jugador {} eliminado!", 
+                           card->getName(), owner->id);
                 
-                // Verificar estado después de destruir una carta
-                checkLegendStatus();
-                return;
+                // Las leyendas destruidas NO regresan al mazo (son únicas)
+                pushCard(owner->discard, card);
             }
+        } else {
+            // Cartas normales regresan al mazo para ser reutilizadas
+            returnCardToDeck(owner->id, card);
         }
     }
+    map.removeCard(map.toIndex(position->first, position->second));
+    unindexCardPosition(card);
+    effectStack.refreshSubscriptions(card, map);
+    // Exit effects watching the cell see the card leave
+    effectStack.processPositionExit(map, map.at(position->first, position->second), this);
+    std::println("Card {} destroyed", card->getName());
+    
+    // Verificar estado después de destruir una carta
+    checkLegendStatus();
 }
 
 // Movement and positioning validation
 bool GameState::canMoveCard(PlayerId playerId, CardPtr card, uint8_t fromX, uint8_t fromY, uint8_t toX, uint8_t toY) const {
-    // Basic movement validation
-    if (!isValidPosition(fromX, fromY) || !isValidPosition(toX, toY)) {
+    if (!card || card->getOwner() != playerId) {
         return false;
     }
     
-    // Check if card is at source position and owned by player
-    const MapCell* fromCell = map.at(fromX, fromY);
-    if (!fromCell || !fromCell->card.has_value() || fromCell->card.value() != card) {
+    // Card must currently be at the source position
+    auto it = cardPositions.find(card.get());
+    if (it == cardPositions.end() || it->second != map.toIndex(fromX, fromY)) {
         return false;
     }
     
-    if (card->getOwner() != playerId) {
-        return false;
-    }
-    
-    // Check if destination is empty
-    return isPositionEmpty(toX, toY);
+    // Destination must be reachable within the unit's speed through walkable, empty cells
+    const CellIndex destination = map.toIndex(toX, toY);
+    return destination != NO_CELL && ((getReachableMask(card) >> destination) & 1u);
 }
 
 bool GameState::isValidPosition(uint8_t x, uint8_t y) const {
-    const MapCell* cell = map.at(x, y);
-    return cell != nullptr && cell->floor != MapCell::FloorType::NONE;
+    return map.isWalkable(map.toIndex(x, y));
 }
 
 bool GameState::isPositionEmpty(uint8_t x, uint8_t y) const {
-    const MapCell* cell = map.at(x, y);
-    return cell && cell->floor != MapCell::FloorType::NONE && !cell->card.has_value();
+    return map.isEmpty(map.toIndex(x, y));
+}
+
+std::optional<std::pair<uint8_t, uint8_t>> GameState::getCardPosition(const CardPtr& card) const {
+    if (!card) return std::nullopt;
+    auto it = cardPositions.find(card.get());
+    if (it == cardPositions.end()) return std::nullopt;
+    return map.toCoordinates(it->second);
+}
+
+void GameState::indexCardPosition(const CardPtr& card, uint8_t x, uint8_t y) {
+    if (journaling) {
+        auto previous = cardPositions.find(card.get());
+        journal.record({.op = GameJournal::Op::POSITION,
+                        .index = previous == cardPositions.end() ? NO_CELL : previous->second, .card = card});
+    }
+    cardPositions[card.get()] = map.toIndex(x, y);
+    if (Unit* unit = Card::as<Unit>(card)) {
+        unit->setPosition(x, y);
+    }
+}
+
+uint64_t GameState::handCardHash(PlayerId playerId, const CardPtr& card) {
+    return Zobrist::key(Zobrist::Domain::HAND, playerId, card->getId());
+}
+
+uint64_t GameState::metaHash() const {
+    // Few scalar fields: cheaper to combine on read than to track on every change
+    uint64_t hash = Zobrist::key(Zobrist::Domain::CURRENT_PLAYER, currentPlayer);
+    hash ^= Zobrist::key(Zobrist::Domain::TURN, turnNumber);
+    hash ^= Zobrist::key(Zobrist::Domain::PHASE, static_cast<uint64_t>(phase));
+    for (const auto& player : players) {
+        hash ^= Zobrist::key(Zobrist::Domain::ACTIONS, player.id, player.actionsRemaining);
+    }
+    return hash;
+}
+
+uint64_t GameState::getStateHash() const {
+    return map.getBoardHash() ^ handHashes[0] ^ handHashes[1] ^ metaHash();
+}
+
+uint64_t GameState::computeStateHash() const {
+    uint64_t hash = map.computeBoardHash();
+    std::array<uint64_t, 2> hands{};
+    for (const auto& player : players) {
+        for (const auto& card : player.hand) {
+            hands[player.id & 1] += handCardHash(player.id, card);
+        }
+    }
+    return hash ^ hands[0] ^ hands[1] ^ metaHash();
+}
+
+uint64_t GameState::getReachableMask(const CardPtr& card) const {
+    const Unit* unit = Card::as<Unit>(card);
+    auto position = unit ? cardPositions.find(card.get()) : cardPositions.end();
+    if (position == cardPositions.end()) {
+        return 0;
+    }
+    
+    const uint64_t occupied = map.getOccupiedMask();
+    ReachabilityEntry& entry = reachabilityCache[card.get()];
+    if (entry.occupied != occupied || entry.origin != position->second || entry.speed != unit->getSpeed()) {
+        entry = {occupied, position->second, unit->getSpeed(),
+                 map.getReachableMask(position->second, unit->getSpeed(), unit->getOwner())};
+    }
+    return entry.reachable;
+}
+
+void GameState::unindexCardPosition(const CardPtr& card) {
+    if (journaling) {
+        auto previous = cardPositions.find(card.get());
+        if (previous != cardPositions.end()) {
+            journal.record({.op = GameJournal::Op::POSITION, .index = previous->second, .card = card});
+        }
+    }
+    cardPositions.erase(card.get());
+    reachabilityCache.erase(card.get());
+    if (Unit* unit = Card::as<Unit>(card)) {
+        unit->removeFromMap();
+    }
 }
 
 // Simple helper methods for small number of players
@@ -714,7 +1015,7 @@ void GameState::placeLegends() {
         std::println("Procesando jugador {}, deck size: {}", player.id, player.deck.size());
         
         // Buscar leyenda en el deck del jugador
-        auto legend = findLegendInDeck(player.deck);
+        auto legend = std::static_pointer_cast<Legend>(findLegendInDeck(player.deck));
         if (!legend) {
             std::println("⚠️  ¡Advertencia! Jugador {} no tiene leyenda en su deck", player.id);
             
@@ -752,16 +1053,17 @@ void GameState::placeLegends() {
             continue;
         }
         
-        if (spawnCell->card.has_value()) {
+        if (spawnCell->hasCard()) {
             std::println("❌ ¡Error! Posición de spawn ({}, {}) ocupada para jugador {}", 
                        spawnX, spawnY, player.id);
             continue;
         }
         
         // Colocar la leyenda en la posición de spawn
-        spawnCell->card = legend;
-        legend->setPosition(spawnX, spawnY);
+        // El dueño se asigna antes de colocarla para que la ocupación quede registrada
         legend->setOwner(player.id);
+        map.placeCard(map.toIndex(spawnX, spawnY), legend);
+        indexCardPosition(legend, spawnX, spawnY);
         
         // Guardar referencia a la leyenda del jugador
         player.legend = legend;
@@ -779,10 +1081,10 @@ std::shared_ptr<Legend> GameState::findLegendInDeck(std::vector<CardPtr>& deck)
     // Buscar y remover TODAS las leyendas del deck (pueden haber duplicadas)
     auto it = deck.begin();
     while (it != deck.end()) {
-        if (auto legend = std::dynamic_pointer_cast<Legend>(*it)) {
+        if ((*it)->isLegend()) {
             if (!foundLegend) {
                 // Guardar la primera leyenda encontrada para devolverla
-                foundLegend = legend;
+                foundLegend = std::static_pointer_cast<Legend>(*it);
             }
             // Remover esta leyenda del deck
             it = deck.erase(it);
@@ -5,11 +5,16 @@
 #include <vector>
 #include <list>
 #include <algorithm>
+#include <functional>
 #include "GameMap.hpp"
+#include "../../libs/flat_hash_map.hpp"
 #include "../effects/EffectStack.hpp"
 #include "../utils/Types.hpp"
 #include "../cards/Card.hpp"
 #include "../config/GameConfig.hpp"
+#include "../utils/GameArena.hpp"
+#include "CloneContext.hpp"
+#include "GameJournal.hpp"
 
 enum class Team : uint8_t {
     NONE = 0,
@@ -69,9 +74,20 @@ struct GameAction {
     std::optional<std::pair<uint8_t, uint8_t>> target;
 };
 
+class GameState;
+inline GameState createNewGame(uint8_t numPlayers = 2);
+
 // Main game state class
 class GameState {
+public:
+    // Builds a player's deck; called with the game's arena active
+    using DeckBuilder = std::function<std::vector<CardPtr>(PlayerId)>;
+
 private:
+    // Declared before the game objects so it is destroyed after them: cards,
+    // effects and list nodes created while it is active live here and are
+    // released together. None of them may outlive this game (see GameArena)
+    GameArena arena;
     GameMap map;
     EffectStack effectStack;
     std::vector<Player> players;
@@ -81,16 +97,105 @@ private:
     uint32_t turnNumber = 0;
     GamePhase phase = GamePhase::SETUP;
     
+    // Authoritative card -> cell index, kept in sync by play/move/destroy
+    // so position lookups never scan the map
+    ska::flat_hash_map<const Card*, CellIndex> cardPositions;
+    
+    // Per-unit reachable set, reused until the board occupancy (or the unit's
+    // cell/speed) changes; entries are dropped when the card leaves the map
+    struct ReachabilityEntry {
+        uint64_t occupied;   // GameMap::getOccupiedMask() when computed
+        CellIndex origin;
+        uint8_t speed;
+        uint64_t reachable;
+    };
+    mutable ska::flat_hash_map<const Card*, ReachabilityEntry> reachabilityCache;
+    
+    // Zobrist hand component per player: sum of hand card keys, so the hand
+    // is hashed as a multiset (order-independent) and updated on draw/play
+    std::array<uint64_t, 2> handHashes{};
+    static uint64_t handCardHash(PlayerId playerId, const CardPtr& card);
+    uint64_t metaHash() const;
+    
+    // Undo journal (make/unmake). Map, stat store and effect stack record their
+    // own mutations; GameState records player lists, positions and owners.
+    // Each outermost public action opens a frame with the scalars it may change
+    GameJournal journal;
+    bool journaling = false;
+    uint32_t actionDepth = 0;
+    
+    struct PlayerSnapshot {
+        uint8_t health;
+        uint8_t actionsRemaining;
+        uint8_t maxActionsPerTurn;
+        uint8_t maxHandSize;
+    };
+    struct UndoFrame {
+        size_t firstEntry;      // journal size when the action started
+        size_t firstPlayer;     // offset into playerSnapshots
+        uint32_t rngState;
+        uint32_t turnNumber;
+        PlayerId currentPlayer;
+        GamePhase phase;
+        std::array<uint64_t, 2> handHashes;
+    };
+    std::vector<UndoFrame> undoFrames;
+    std::vector<PlayerSnapshot> playerSnapshots;
+    
+    // Opens a frame if this is the outermost journaled action
+    class ActionScope {
+        GameState& game;
+    public:
+        explicit ActionScope(GameState& gameState);
+        ~ActionScope() { --game.actionDepth; }
+        ActionScope(const ActionScope&) = delete;
+        ActionScope& operator=(const ActionScope&) = delete;
+    };
+    void undoEntry(const GameJournal::Entry& entry);
+    
+    // Journaled edits of player card lists and card fields
+    void pushCard(std::vector<CardPtr>& list, CardPtr card);
+    CardPtr popCard(std::vector<CardPtr>& list);
+    void eraseCard(std::vector<CardPtr>& list, size_t index);
+    void insertCard(std::vector<CardPtr>& list, size_t index, CardPtr card);
+    void saveList(std::vector<CardPtr>& list);
+    void setCardOwner(const CardPtr& card, PlayerId owner);
+    
     // Lightweight thread-local RNG for better performance with multiple games
     // Using a simple but fast LCG (Linear Congruential Generator)
     static thread_local uint32_t rng_state;
     
+    // Remap table size for a whole game (cards and effects of both decks)
+    static constexpr size_t CLONE_RESERVE = 64;
+    // Deep copy of source; card and effect references are remapped through context
+    GameState(const GameState& source, CloneContext& context);
+    
+    // Players without decks, for createNewGame. GameState can be neither
+    // copied nor moved (placed units read their stats from the map's store,
+    // the map and effect stack point at the journal), so the factory returns
+    // a prvalue that is built directly in the caller's object
+    struct EmptyPlayers { uint8_t count; };
+    explicit GameState(EmptyPlayers players);
+    friend GameState createNewGame(uint8_t numPlayers);
+    
     // Internal helper methods
+    void setupPlayers(std::vector<CardPtr> deck1, std::vector<CardPtr> deck2);
     void drawCard(Player& player, uint8_t count = 1);
     
     // Método para devolver una carta al mazo del jugador y barajarlo
     void returnCardToDeck(PlayerId playerId, CardPtr card);
     
+    // Pushes a played card's effect and schedules its expiry from its duration
+    void stackEffect(const EffectPtr& effect);
+    
+    // Player turns played so far (turnNumber counts rounds): effect durations
+    // are measured in these, so 0 ends with the caster's turn whatever the seat
+    uint32_t elapsedTurns() const;
+    
+    // Card position index maintenance (also mirrors the position into Unit)
+    void indexCardPosition(const CardPtr& card, uint8_t x, uint8_t y);
+    void unindexCardPosition(const CardPtr& card);
+    
     // Simple helper methods (no cache needed for few players)
     Player* findPlayer(PlayerId id);
     const Player* findPlayer(PlayerId id) const;
@@ -108,6 +213,28 @@ public:
     GameState();
     GameState(const GameConfig& config);
     GameState(std::vector<CardPtr> deck1, std::vector<CardPtr> deck2, const GameConfig& config);
+    // Preferred for game churn: decks are allocated in this game's arena
+    GameState(const DeckBuilder& buildDeck, const GameConfig& config);
+    
+    GameState(const GameState&) = delete;
+    GameState& operator=(const GameState&) = delete;
+    // Breaks the card <-> effect cycles so every object of the game is
+    // destroyed before its arena is released (see GameArena)
+    ~GameState();
+    
+    // Independent deep copy for search and what-if analysis: cards, effects,
+    // triggers and selectors are copied into the clone's arena and every
+    // reference between them is remapped. The clone hashes equal to this game
+    std::shared_ptr<GameState> clone() const;
+    
+    // Undo journal: while enabled, every public action (play, move, attack,
+    // destroy, damage, end turn) can be reverted exactly with undo(), including
+    // effect stat changes, effect stack edits and the RNG. Setup is not journaled
+    void enableJournal(bool enabled = true);
+    bool isJournaling() const { return journaling; }
+    size_t getUndoDepth() const { return undoFrames.size(); }
+    // Reverts the last count actions (fewer if not that many were journaled)
+    void undo(size_t count = 1);
     
     // Game setup
     void addPlayer(PlayerId id, Team team, const std::string& name);
@@ -141,11 +268,24 @@ public:
     bool isPositionEmpty(uint8_t x, uint8_t y) const;
     bool isPlayerAlive(PlayerId playerId) const;
     
+    // Cells a unit can move to this turn (speed-bounded BFS, cached per unit)
+    uint64_t getReachableMask(const CardPtr& card) const;
+    
+    // 64-bit Zobrist hash of the position: board (units and their stats, kept
+    // incrementally by GameMap), hands, current player, actions, turn and phase
+    uint64_t getStateHash() const;
+    // Full recomputation, used to validate the incremental hash
+    uint64_t computeStateHash() const;
+    
+    // O(1) lookup of where a card lives on the map (nullopt if not on the map)
+    std::optional<std::pair<uint8_t, uint8_t>> getCardPosition(const CardPtr& card) const;
+    
     // State queries
     GamePhase getPhase() const { return phase; }
     PlayerId getCurrentPlayer() const { return currentPlayer; }
     uint32_t getTurnNumber() const { return turnNumber; }
     const GameMap& getMap() const { return map; }
+    const EffectStack& getEffectStack() const { return effectStack; }
     GameMap& getMap() { return map; }
     const Player& getPlayer(PlayerId id) const;
     
@@ -195,20 +335,10 @@ inline std::string to_string(const GameState& gameState) {
     return result;
 }
 
-// Game setup factory methods
-inline GameState createNewGame(uint8_t numPlayers = 2) {
-    GameState gameState;
-    
-    for (uint8_t i = 0; i < numPlayers; ++i) {
-        PlayerId id = i + 1;
-        Team team = (i & 1) ? Team::TEAM_B : Team::TEAM_A;
-        std::string name = "Player " + std::to_string(id);
-        
-        gameState.addPlayer(id, team, name);
-    }
-    
-    return gameState;
-}
-
 // Convenience types
 using GameStatePtr = std::shared_ptr<GameState>;
+
+// Game setup factory methods
+inline GameState createNewGame(uint8_t numPlayers) {
+    return GameState(GameState::EmptyPlayers{numPlayers});
+}
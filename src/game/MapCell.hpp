@@ -1,13 +1,12 @@
 #pragma once
-#include <functional>
-#include <optional>
 #include <cstdint>
 #include <string>
-#include <memory>
+#include <type_traits>
 #include "../utils/StrColors.hpp"
 #include "../utils/Types.hpp"
-#include "../cards/Card.hpp" // Incluir definición completa de Unit
 
+// Celda compacta: byte de suelo + handle de 16 bits a la EntityTable del mapa.
+// Es trivialmente copiable, así que el tablero completo se copia con un memcpy.
 class MapCell {
 
     public :
@@ -15,34 +14,35 @@ class MapCell {
             NONE,
             WALKABLE,
             SPAWN // Nuevo: posición de spawn para leyendas
-        };        
-        FloorType floor;
-        std::optional<CardPtr> card;
-        
+        };
+        FloorType floor = FloorType::NONE;
+        EntityId entity = NO_ENTITY;
+
         MapCell() = default;
-        MapCell(FloorType floorType) : 
-            floor(floorType), 
-            card(std::nullopt) {}
+        MapCell(FloorType floorType) :
+            floor(floorType),
+            entity(NO_ENTITY) {}
 
         bool isSpawn() const { return floor == FloorType::SPAWN; }
+        bool hasCard() const { return entity != NO_ENTITY; }
 
-        operator std::string() const {
+        // El tipo de carta lo conoce GameMap (máscara de leyendas), no la celda
+        std::string render(bool holdsLegend) const {
             using namespace StrColors;
-            
-            if (card.has_value()) {
-                auto cardPtr = card.value();
-                // Verificar si es una leyenda
-                if (auto unit = std::dynamic_pointer_cast<Unit>(cardPtr)) {
-                    if (unit->isLegend()) {
-                        return BLUE + "⬣" + RESET; // Leyenda: azul
-                    }
+
+            if (hasCard()) {
+                if (holdsLegend) {
+                    return BLUE + "⬣" + RESET; // Leyenda: azul
                 }
                 return RED + "⬣" + RESET;        // Carta normal: rojo
             }
             if (floor == FloorType::SPAWN) return YELLOW + "⬣" + RESET; // Spawn: amarillo
             if (floor == FloorType::WALKABLE) return GREEN + "⬣" + RESET;// Caminable: verde
-            
-            return "⬡";     
+
+            return "⬡";
         }
 
 };
+
+static_assert(std::is_trivially_copyable_v<MapCell>, "MapCell must stay trivially copyable");
+static_assert(sizeof(MapCell) == 4, "MapCell should be a floor byte plus a 16-bit entity handle");
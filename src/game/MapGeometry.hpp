@@ -0,0 +1,286 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <tuple>
+#include "../utils/Types.hpp"
+
+// Geometría precalculada del mapa hexagonal.
+// Todas las tablas se generan en tiempo de compilación para unas dimensiones dadas,
+// de modo que las consultas de vecindad son una sola lectura de tabla.
+namespace MapGeometryDetail {
+
+    inline constexpr uint8_t DIRECTION_COUNT = 6;
+    inline constexpr uint8_t ORIENTATION_COUNT = 2; // Jugador 0 y jugador 1 (reflejado)
+
+    // Desplazamientos (dx, dy) en el orden de GameMap::Adjacency
+    inline constexpr std::array<std::pair<int8_t, int8_t>, DIRECTION_COUNT> DIRECTION_OFFSETS = {{
+        {0, -1}, // UP
+        {1,  0}, // TOP_RIGHT
+        {1,  1}, // BOTTOM_RIGHT
+        {0,  1}, // DOWN
+        {-1, 1}, // BOTTOM_LEFT
+        {-1, 0}  // TOP_LEFT
+    }};
+
+    // Reflejo vertical usado por el jugador 1
+    inline constexpr std::array<uint8_t, DIRECTION_COUNT> INVERTED_DIRECTIONS = {
+        3, // UP -> DOWN
+        2, // TOP_RIGHT -> BOTTOM_RIGHT
+        1, // BOTTOM_RIGHT -> TOP_RIGHT
+        0, // DOWN -> UP
+        5, // BOTTOM_LEFT -> TOP_LEFT
+        4  // TOP_LEFT -> BOTTOM_LEFT
+    };
+
+    // Orientación del tablero según el jugador (solo el jugador 1 se refleja)
+    constexpr uint8_t orientationOf(PlayerId playerId) {
+        return playerId == 1 ? 1 : 0;
+    }
+
+    // Tabla [orientación][celda][dirección] -> celda vecina o NO_CELL.
+    // Se dimensiona a 256 celdas para que NO_CELL también sea una fila válida
+    // (que solo contiene NO_CELL) y la consulta no necesite comprobar límites.
+    using NeighborTable = std::array<std::array<std::array<CellIndex, DIRECTION_COUNT>, 256>, ORIENTATION_COUNT>;
+
+    // Máscara de bits [orientación][celda] con todas las celdas vecinas
+    using AdjacencyTable = std::array<std::array<uint64_t, 256>, ORIENTATION_COUNT>;
+
+    // Distancia en pasos [origen][destino]; UNREACHABLE si no hay camino
+    inline constexpr uint8_t UNREACHABLE = 0xFF;
+    using DistanceTable = std::array<std::array<uint8_t, 64>, 64>;
+
+    // Rangos mayores se recortan a MAX_RANGE (cubre el diámetro de todos los tableros soportados)
+    inline constexpr uint8_t MAX_RANGE = 15;
+    // Máscara [celda][rango] con las celdas a distancia 1..rango
+    using RangeTable = std::array<std::array<uint64_t, MAX_RANGE + 1>, 64>;
+
+    // Rayo: celdas en orden desde la vecina de la celda origen hasta el borde del mapa
+    inline constexpr uint8_t MAX_RAY_LENGTH = 8;
+    struct Ray {
+        uint8_t length = 0;
+        std::array<CellIndex, MAX_RAY_LENGTH> cells{};
+    };
+    // Rayos [orientación][celda][dirección]
+    using RayTable = std::array<std::array<std::array<Ray, DIRECTION_COUNT>, 64>, ORIENTATION_COUNT>;
+
+} // namespace MapGeometryDetail
+
+// Vista en tiempo de ejecución de una geometría precompilada.
+// GameMap guarda una de estas para el tamaño elegido en la configuración y
+// lee sus tablas a través del puntero: el tamaño se elige al arrancar.
+struct MapLayout {
+    uint8_t width;
+    uint8_t height;
+    uint8_t cellCount;
+    const MapGeometryDetail::NeighborTable* neighbors;
+    const MapGeometryDetail::AdjacencyTable* adjacency;
+    uint64_t walkableMask;      // Celdas con suelo (incluye spawns)
+    uint64_t spawnMask;         // Posiciones de spawn de leyendas
+    std::array<CellIndex, 2> spawnCells; // Spawn por jugador
+    std::array<uint64_t, 2> territoryMasks; // Mitad del mapa de cada jugador (la fila central es compartida)
+    const MapGeometryDetail::DistanceTable* distances;
+    const MapGeometryDetail::RangeTable* rangeMasks;
+    const MapGeometryDetail::RayTable* rays;
+};
+
+template <uint8_t Width, uint8_t Height>
+struct MapGeometry {
+    static constexpr uint8_t WIDTH = Width;
+    static constexpr uint8_t HEIGHT = Height;
+    static constexpr uint8_t CELL_COUNT = Width * Height;
+
+    // Las máscaras de adyacencia usan un bit por celda
+    static_assert(Width * Height <= 64, "MapGeometry requires at most 64 cells");
+
+    static constexpr CellIndex toIndex(uint8_t x, uint8_t y) {
+        return x >= Width || y >= Height ? NO_CELL : static_cast<CellIndex>(y * Width + x);
+    }
+
+    static constexpr std::pair<uint8_t, uint8_t> toCoordinates(CellIndex index) {
+        return index >= CELL_COUNT ?
+            std::pair<uint8_t, uint8_t>{255, 255} :
+            std::pair<uint8_t, uint8_t>{index % Width, index / Width};
+    }
+
+    using NeighborTable = MapGeometryDetail::NeighborTable;
+    using AdjacencyTable = MapGeometryDetail::AdjacencyTable;
+
+    static constexpr NeighborTable NEIGHBORS = [] {
+        using namespace MapGeometryDetail;
+        NeighborTable table{};
+        for (auto& orientation : table) {
+            for (auto& row : orientation) row.fill(NO_CELL);
+        }
+
+        for (uint8_t orientation = 0; orientation < ORIENTATION_COUNT; ++orientation) {
+            for (uint8_t cell = 0; cell < CELL_COUNT; ++cell) {
+                const int x = cell % Width, y = cell / Width;
+                for (uint8_t direction = 0; direction < DIRECTION_COUNT; ++direction) {
+                    const uint8_t effective = orientation == 1 ? INVERTED_DIRECTIONS[direction] : direction;
+                    const int nx = x + DIRECTION_OFFSETS[effective].first;
+                    const int ny = y + DIRECTION_OFFSETS[effective].second;
+                    if (nx >= 0 && ny >= 0 && nx < Width && ny < Height) {
+                        table[orientation][cell][direction] = static_cast<CellIndex>(ny * Width + nx);
+                    }
+                }
+            }
+        }
+        return table;
+    }();
+
+    static constexpr AdjacencyTable ADJACENCY_MASKS = [] {
+        using namespace MapGeometryDetail;
+        AdjacencyTable masks{};
+        for (uint8_t orientation = 0; orientation < ORIENTATION_COUNT; ++orientation) {
+            for (uint8_t cell = 0; cell < CELL_COUNT; ++cell) {
+                for (CellIndex neighbor : NEIGHBORS[orientation][cell]) {
+                    if (neighbor != NO_CELL) masks[orientation][cell] |= uint64_t{1} << neighbor;
+                }
+            }
+        }
+        return masks;
+    }();
+
+    // El conjunto de desplazamientos es el mismo para ambas orientaciones (solo cambia
+    // el nombre de cada dirección), así que las distancias no dependen del jugador.
+    // Los desplazamientos no son simétricos, por lo que la distancia es dirigida
+    // (origen -> destino) y coincide con isNeighbor para distancia 1.
+    static_assert(Width + Height - 2 <= MapGeometryDetail::MAX_RANGE, "MapGeometry diameter exceeds MAX_RANGE");
+
+    using DistanceTable = MapGeometryDetail::DistanceTable;
+    using RangeTable = MapGeometryDetail::RangeTable;
+
+    static constexpr DistanceTable DISTANCES = [] {
+        using namespace MapGeometryDetail;
+        DistanceTable distances{};
+        for (auto& row : distances) row.fill(UNREACHABLE);
+
+        // BFS desde cada celda sobre las máscaras de adyacencia
+        for (uint8_t source = 0; source < CELL_COUNT; ++source) {
+            uint64_t visited = uint64_t{1} << source;
+            uint64_t frontier = visited;
+            distances[source][source] = 0;
+            for (uint8_t step = 1; frontier; ++step) {
+                uint64_t next = 0;
+                for (uint8_t cell = 0; cell < CELL_COUNT; ++cell) {
+                    if ((frontier >> cell) & 1u) next |= ADJACENCY_MASKS[0][cell];
+                }
+                next &= ~visited;
+                for (uint8_t cell = 0; cell < CELL_COUNT; ++cell) {
+                    if ((next >> cell) & 1u) distances[source][cell] = step;
+                }
+                visited |= next;
+                frontier = next;
+            }
+        }
+        return distances;
+    }();
+
+    static constexpr RangeTable RANGE_MASKS = [] {
+        using namespace MapGeometryDetail;
+        RangeTable masks{};
+        for (uint8_t source = 0; source < CELL_COUNT; ++source) {
+            for (uint8_t target = 0; target < CELL_COUNT; ++target) {
+                const uint8_t distance = DISTANCES[source][target];
+                if (distance == 0 || distance == UNREACHABLE) continue;
+                for (uint8_t range = distance; range <= MAX_RANGE; ++range) {
+                    masks[source][range] |= uint64_t{1} << target;
+                }
+            }
+        }
+        return masks;
+    }();
+
+    static_assert(Width <= MapGeometryDetail::MAX_RAY_LENGTH + 1 && Height <= MapGeometryDetail::MAX_RAY_LENGTH + 1,
+                  "MapGeometry rays exceed MAX_RAY_LENGTH");
+
+    using RayTable = MapGeometryDetail::RayTable;
+
+    // Encadena la tabla de vecinos hasta salir del mapa
+    static constexpr RayTable RAYS = [] {
+        using namespace MapGeometryDetail;
+        RayTable rays{};
+        for (uint8_t orientation = 0; orientation < ORIENTATION_COUNT; ++orientation) {
+            for (uint8_t cell = 0; cell < CELL_COUNT; ++cell) {
+                for (uint8_t direction = 0; direction < DIRECTION_COUNT; ++direction) {
+                    Ray& ray = rays[orientation][cell][direction];
+                    for (CellIndex next = NEIGHBORS[orientation][cell][direction]; next != NO_CELL;
+                         next = NEIGHBORS[orientation][next][direction]) {
+                        ray.cells[ray.length++] = next;
+                    }
+                }
+            }
+        }
+        return rays;
+    }();
+
+    // Spawns de leyendas: centro de la primera y de la última fila
+    static constexpr std::array<CellIndex, 2> SPAWN_CELLS = {
+        toIndex(Width / 2, 0), toIndex(Width / 2, Height - 1)
+    };
+
+    // Plantilla de suelo generalizada a partir del tablero original de 5x7:
+    // la mitad del jugador 1 es abierta, la del jugador 0 se estrecha hacia su spawn
+    static constexpr bool isWalkable(uint8_t x, uint8_t y) {
+        return (y >= Height / 2 && y < Height - 1) ||
+               x == Width / 2 ||
+               (y == Height / 2 - 1 && x >= 1 && x < Width - 1);
+    }
+
+    static constexpr uint64_t SPAWN_MASK = (uint64_t{1} << SPAWN_CELLS[0]) | (uint64_t{1} << SPAWN_CELLS[1]);
+
+    static constexpr uint64_t WALKABLE_MASK = [] {
+        uint64_t mask = SPAWN_MASK;
+        for (uint8_t cell = 0; cell < CELL_COUNT; ++cell) {
+            if (isWalkable(cell % Width, cell / Width)) mask |= uint64_t{1} << cell;
+        }
+        return mask;
+    }();
+
+    static constexpr std::array<uint64_t, 2> TERRITORY_MASKS = [] {
+        std::array<uint64_t, 2> masks{};
+        for (uint8_t cell = 0; cell < CELL_COUNT; ++cell) {
+            const uint8_t y = cell / Width;
+            if (y <= Height / 2) masks[0] |= uint64_t{1} << cell;
+            if (y >= Height / 2) masks[1] |= uint64_t{1} << cell;
+        }
+        return masks;
+    }();
+
+    static constexpr MapLayout LAYOUT = {
+        Width, Height, CELL_COUNT, &NEIGHBORS, &ADJACENCY_MASKS,
+        WALKABLE_MASK, SPAWN_MASK, SPAWN_CELLS, TERRITORY_MASKS, &DISTANCES, &RANGE_MASKS, &RAYS
+    };
+
+    static constexpr CellIndex neighbor(uint8_t direction, CellIndex cell, PlayerId playerId) {
+        return NEIGHBORS[MapGeometryDetail::orientationOf(playerId)][cell][direction];
+    }
+
+    static constexpr bool isNeighbor(CellIndex cell, CellIndex candidate, PlayerId playerId) {
+        return candidate < CELL_COUNT &&
+               ((ADJACENCY_MASKS[MapGeometryDetail::orientationOf(playerId)][cell] >> candidate) & 1u);
+    }
+};
+
+// Tamaños de tablero precompilados. El primero es el tablero por defecto (5x7);
+// game_config.conf elige uno con map_width / map_height.
+using SupportedMapGeometries = std::tuple<
+    MapGeometry<5, 7>,
+    MapGeometry<7, 7>,
+    MapGeometry<7, 9>
+>;
+
+inline constexpr std::array<const MapLayout*, std::tuple_size_v<SupportedMapGeometries>> SUPPORTED_MAP_LAYOUTS = {
+    &std::tuple_element_t<0, SupportedMapGeometries>::LAYOUT,
+    &std::tuple_element_t<1, SupportedMapGeometries>::LAYOUT,
+    &std::tuple_element_t<2, SupportedMapGeometries>::LAYOUT
+};
+
+// Busca la geometría precompilada para unas dimensiones (nullptr si no existe)
+constexpr const MapLayout* findMapLayout(uint8_t width, uint8_t height) {
+    for (const MapLayout* layout : SUPPORTED_MAP_LAYOUTS) {
+        if (layout->width == width && layout->height == height) return layout;
+    }
+    return nullptr;
+}
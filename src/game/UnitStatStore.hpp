@@ -0,0 +1,346 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include "../utils/Types.hpp"
+#include "../utils/SmallVector.hpp"
+#include "../../libs/flat_hash_map.hpp"
+#include "GameJournal.hpp"
+
+// Estadísticas de las unidades colocadas en el mapa, en columnas contiguas
+// (struct-of-arrays) indexadas por el handle de entidad: slot = EntityId - 1.
+// Mientras una unidad está en el mapa estas columnas son la fuente de verdad
+// y los getters de Unit leen de aquí. Como cada entidad ocupa una celda, nunca
+// hay más de 64 handles vivos y las columnas tienen tamaño fijo.
+//
+// attack, speed y range tienen además una capa de modificadores (auras): las
+// columnas guardan el valor base y el efectivo (base + modificadores) se
+// recalcula al leerlo, solo en los slots marcados como sucios, a partir de
+// la suma de modificadores de cada slot (que se mantiene al añadir y quitar). Cada
+// modificador lleva la clave del efecto que lo aplica, así que dos efectos de
+// una misma carta sobre la misma estadística no se pisan, y un índice por
+// clave permite quitar las auras de un efecto sin recorrer la lista.
+class UnitStatStore {
+    public:
+        static constexpr size_t CAPACITY = 64;
+
+        using Values = std::array<uint8_t, CAPACITY>;
+        using Column = Values UnitStatStore::*;
+        // Byte por slot (0 o 1): entidades a las que se aplica un kernel
+        using Selection = std::array<uint8_t, CAPACITY>;
+
+        Values attack{};
+        Values health{};
+        Values maxHealth{};
+        Values speed{};
+        Values range{};
+
+        // Orden de las columnas en el registro de deshacer
+        static constexpr std::array<Column, 5> COLUMNS = {
+            &UnitStatStore::attack, &UnitStatStore::health, &UnitStatStore::maxHealth,
+            &UnitStatStore::speed, &UnitStatStore::range
+        };
+
+        // Columnas con capa de modificadores y su valor mínimo (el de los kernels)
+        static constexpr std::array<Column, 3> LAYERS = {
+            &UnitStatStore::attack, &UnitStatStore::speed, &UnitStatStore::range
+        };
+        static constexpr std::array<int, 3> LAYER_MINIMUM = {0, 1, 1};
+        static constexpr int NO_LAYER = -1;
+
+        // Identificador del efecto dueño de un aura (0: sin efecto)
+        using AuraKey = uint32_t;
+        static constexpr AuraKey NO_AURA = 0;
+
+        // Modificador activo: delta sobre una estadística de un slot, etiquetado
+        // con el efecto que lo aplica y la unidad fuente de ese efecto
+        // (NO_ENTITY: sin fuente, dura hasta que la unidad deja el mapa)
+        struct Modifier {
+            AuraKey key = NO_AURA;
+            EntityId source = NO_ENTITY;
+            uint8_t slot = 0;
+            uint8_t layer = 0;
+            int8_t delta = 0;
+            uint16_t keyPosition = 0;  // Posición en keyModifiers[key]
+        };
+
+        // Registro de deshacer de la partida (nullptr si no se registra). Lo
+        // asigna GameMap; load/release no se registran (los deshace el mapa)
+        GameJournal* journal = nullptr;
+
+        static constexpr size_t slotOf(EntityId id) { return static_cast<size_t>(id) - 1; }
+        static constexpr EntityId entityOf(size_t slot) { return static_cast<EntityId>(slot + 1); }
+
+        // Slots ocupados por unidades (bit i = slot i); hechizos y vacíos quedan a 0
+        uint64_t unitSlots = 0;
+
+        bool isUnit(EntityId id) const {
+            return id != NO_ENTITY && slotOf(id) < CAPACITY && ((unitSlots >> slotOf(id)) & 1u);
+        }
+
+        void load(EntityId id, uint8_t atk, uint8_t hp, uint8_t maxHp, uint8_t spd, uint8_t rng) {
+            const size_t slot = slotOf(id);
+            attack[slot] = atk;
+            health[slot] = hp;
+            maxHealth[slot] = maxHp;
+            speed[slot] = spd;
+            range[slot] = rng;
+            unitSlots |= uint64_t{1} << slot;
+            dirty |= uint64_t{1} << slot;
+        }
+
+        // Los modificadores de la unidad se quitan antes (dropModifiers)
+        void release(EntityId id) {
+            const size_t slot = slotOf(id);
+            attack[slot] = health[slot] = maxHealth[slot] = speed[slot] = range[slot] = 0;
+            unitSlots &= ~(uint64_t{1} << slot);
+        }
+
+        // Valor efectivo de una estadística (base + modificadores)
+        uint8_t get(Column column, EntityId id) const {
+            const size_t slot = slotOf(id);
+            const int layer = layerOf(column);
+            if (layer == NO_LAYER || !((modified >> slot) & 1u)) return (this->*column)[slot];
+            if ((dirty >> slot) & 1u) resolve(slot);
+            return effective[layer][slot];
+        }
+
+        // Valor base, sin modificadores
+        uint8_t base(Column column, EntityId id) const { return (this->*column)[slotOf(id)]; }
+
+        // Estadísticas efectivas empaquetadas para el hash Zobrist del tablero
+        uint64_t packed(EntityId id) const {
+            const size_t slot = slotOf(id);
+            return uint64_t{get(&UnitStatStore::attack, id)} | uint64_t{health[slot]} << 8 |
+                   uint64_t{maxHealth[slot]} << 16 | uint64_t{get(&UnitStatStore::speed, id)} << 24 |
+                   uint64_t{get(&UnitStatStore::range, id)} << 32;
+        }
+
+        // Escritura del valor base de una estadística, que queda en el registro de deshacer
+        void write(Column column, EntityId id, uint8_t value) {
+            uint8_t& stat = (this->*column)[slotOf(id)];
+            if (journal) remember(column, slotOf(id), stat);
+            stat = value;
+            dirty |= uint64_t{1} << slotOf(id);
+        }
+
+        // Inversa de una entrada STAT o MODIFIER_*
+        void undo(const GameJournal::Entry& entry) {
+            if (entry.op == GameJournal::Op::STAT) {
+                (this->*COLUMNS[entry.small])[entry.index] = static_cast<uint8_t>(entry.value);
+                dirty |= uint64_t{1} << entry.index;
+            } else if (entry.op == GameJournal::Op::MODIFIER_ADD) {
+                dirty |= uint64_t{1} << modifiers.back().slot;
+                unindex(modifiers.size() - 1);
+                modifiers.pop_back();
+            } else if (entry.op == GameJournal::Op::MODIFIER_REMOVE) {
+                const Modifier modifier = unpack(entry.value, entry.entity);
+                if (entry.index != modifiers.size()) {
+                    // El que ocupó su posición vuelve al final
+                    modifiers.push_back(modifiers[entry.index]);
+                    keyModifiers.find(modifiers.back().key)->second[modifiers.back().keyPosition] =
+                        static_cast<uint16_t>(modifiers.size() - 1);
+                    modifiers[entry.index] = modifier;
+                } else {
+                    modifiers.push_back(modifier);
+                }
+                index(entry.index);
+                modified |= uint64_t{1} << modifier.slot;
+                dirty |= uint64_t{1} << modifier.slot;
+            }
+        }
+
+        // ===== MODIFICADORES =====
+        // Añadir es O(1) y quitar las auras de un efecto es O(1) por modificador
+        // (índice por clave y borrado por intercambio con el último). Cuando una
+        // unidad deja el mapa se recorre la lista compacta de modificadores
+        // activos. Los slots afectados quedan sucios y el valor efectivo se
+        // recalcula en la siguiente lectura. Quien los llame debe refrescar el
+        // hash de las celdas afectadas (GameMap::addModifier/removeModifiers)
+
+        void addModifier(AuraKey key, EntityId source, EntityId target, Column column, int delta) {
+            const int layer = layerOf(column);
+            if (layer == NO_LAYER || !isUnit(target) || delta == 0) return;
+            const uint8_t slot = static_cast<uint8_t>(slotOf(target));
+            if (journal) {
+                journal->record({.op = GameJournal::Op::MODIFIER_ADD, .index = static_cast<uint32_t>(modifiers.size())});
+            }
+            modifiers.push_back({key, source, slot, static_cast<uint8_t>(layer),
+                                 static_cast<int8_t>(std::clamp(delta, -128, 127))});
+            index(modifiers.size() - 1);
+            modified |= uint64_t{1} << slot;
+            dirty |= uint64_t{1} << slot;
+        }
+
+        // Quita los modificadores de un efecto sobre una columna (todas si
+        // column es nullptr) y devuelve los slots afectados
+        uint64_t removeModifiers(AuraKey key, Column column = nullptr) {
+            const int layer = column ? layerOf(column) : NO_LAYER;
+            auto found = keyModifiers.find(key);
+            if (found == keyModifiers.end()) return 0;
+            uint64_t affected = 0;
+            // Desde el final: erase trae a la posición i uno ya visitado
+            for (size_t i = found->second.size(); i-- > 0;) {
+                const size_t position = found->second[i];
+                if (layer != NO_LAYER && modifiers[position].layer != layer) continue;
+                const bool lastOfKey = found->second.size() == 1;
+                affected |= erase(position);  // Con el último se borra la entrada del índice
+                if (lastOfKey) break;
+            }
+            dirty |= affected;
+            return affected;
+        }
+
+        // Una unidad deja el mapa: se quitan sus modificadores y las auras que
+        // aplicaba a otras. Devuelve los slots afectados
+        uint64_t dropModifiers(EntityId id) {
+            const uint8_t slot = static_cast<uint8_t>(slotOf(id));
+            uint64_t affected = 0;
+            for (size_t i = modifiers.size(); i-- > 0;) {
+                if (modifiers[i].slot == slot || modifiers[i].source == id) affected |= erase(i);
+            }
+            dirty |= affected;
+            return affected;
+        }
+
+        // El efecto ya aplica exactamente delta sobre estos slots (y a ninguno más)
+        bool hasAura(AuraKey key, Column column, uint64_t slots, int delta) const {
+            const int layer = layerOf(column);
+            auto positions = keyModifiers.find(key);
+            if (positions == keyModifiers.end()) return slots == 0;
+            uint64_t found = 0;
+            for (uint16_t position : positions->second) {
+                const Modifier& modifier = modifiers[position];
+                if (modifier.layer != layer) continue;
+                if (modifier.delta != delta || (found >> modifier.slot) & 1u) return false;
+                found |= uint64_t{1} << modifier.slot;
+            }
+            return found == slots;
+        }
+
+        size_t getModifierCount() const { return modifiers.size(); }
+
+        // ===== KERNELS =====
+        // Recorren la columna completa sin saltos: el compilador los vectoriza.
+        // Los slots no seleccionados conservan su valor
+
+        // column[i] = clamp(column[i] + delta, minValue, 255) en los seleccionados
+        static void addClamped(Values& column, const Selection& selection, int delta, int minValue) {
+            for (size_t i = 0; i < CAPACITY; ++i) {
+                const int updated = std::clamp(column[i] + delta, minValue, 255);
+                column[i] = selection[i] ? static_cast<uint8_t>(updated) : column[i];
+            }
+        }
+
+        // Los kernels de attack, speed y range cambian el valor base
+        void addAttack(const Selection& selection, int delta) { remember(&UnitStatStore::attack, selection); addClamped(attack, selection, delta, 0); dirty |= modified; }
+        void addSpeed(const Selection& selection, int delta) { remember(&UnitStatStore::speed, selection); addClamped(speed, selection, delta, 1); dirty |= modified; }
+        void addRange(const Selection& selection, int delta) { remember(&UnitStatStore::range, selection); addClamped(range, selection, delta, 1); dirty |= modified; }
+
+        // Curación (delta > 0) o daño (delta < 0): la salud queda en [0, maxHealth]
+        void addHealth(const Selection& selection, int delta) {
+            remember(&UnitStatStore::health, selection);
+            for (size_t i = 0; i < CAPACITY; ++i) {
+                const int updated = std::clamp(health[i] + delta, 0, static_cast<int>(maxHealth[i]));
+                health[i] = selection[i] ? static_cast<uint8_t>(updated) : health[i];
+            }
+        }
+
+    private:
+        SmallVector<Modifier, 16> modifiers;
+        // Posiciones en modifiers de los modificadores de cada efecto
+        using KeyPositions = SmallVector<uint16_t, 8>;
+        ska::flat_hash_map<AuraKey, KeyPositions> keyModifiers;
+        mutable uint64_t modified = 0;          // Slots con algún modificador (se limpia al resolver)
+        mutable uint64_t dirty = 0;             // Slots cuyo valor efectivo hay que recalcular
+        mutable std::array<Values, 3> effective{};
+        std::array<std::array<int32_t, CAPACITY>, 3> layerSums{};  // Suma de los deltas por capa y slot
+        std::array<uint16_t, CAPACITY> slotModifiers{};            // Modificadores activos por slot
+
+        static constexpr int layerOf(Column column) {
+            if (column == &UnitStatStore::attack) return 0;
+            if (column == &UnitStatStore::speed) return 1;
+            if (column == &UnitStatStore::range) return 2;
+            return NO_LAYER;
+        }
+
+        // Recalcula los valores efectivos de un slot sucio
+        void resolve(size_t slot) const {
+            for (size_t layer = 0; layer < LAYERS.size(); ++layer) {
+                const int value = (this->*LAYERS[layer])[slot] + layerSums[layer][slot];
+                effective[layer][slot] = static_cast<uint8_t>(std::clamp(value, LAYER_MINIMUM[layer], 255));
+            }
+            dirty &= ~(uint64_t{1} << slot);
+            if (!slotModifiers[slot]) modified &= ~(uint64_t{1} << slot);
+        }
+
+        // Alta y baja de un modificador en el índice de su clave y en las sumas de su slot
+        void index(size_t position) {
+            Modifier& modifier = modifiers[position];
+            KeyPositions& positions = keyModifiers[modifier.key];
+            modifier.keyPosition = static_cast<uint16_t>(positions.size());
+            positions.push_back(static_cast<uint16_t>(position));
+            layerSums[modifier.layer][modifier.slot] += modifier.delta;
+            ++slotModifiers[modifier.slot];
+        }
+
+        void unindex(size_t position) {
+            const Modifier& modifier = modifiers[position];
+            layerSums[modifier.layer][modifier.slot] -= modifier.delta;
+            --slotModifiers[modifier.slot];
+            auto found = keyModifiers.find(modifier.key);
+            KeyPositions& positions = found->second;
+            const uint16_t keyPosition = modifiers[position].keyPosition;
+            positions[keyPosition] = positions.back();
+            modifiers[positions[keyPosition]].keyPosition = keyPosition;
+            positions.pop_back();
+            if (positions.empty()) keyModifiers.erase(found);
+        }
+
+        // Borrado por intercambio con el último; el registro guarda la posición
+        // y el modificador para reconstruir el orden exacto al deshacer.
+        // Devuelve el slot afectado (quien llama lo marca como sucio)
+        uint64_t erase(size_t position) {
+            const Modifier removed = modifiers[position];
+            if (journal) {
+                journal->record({.op = GameJournal::Op::MODIFIER_REMOVE, .entity = removed.source,
+                                 .index = static_cast<uint32_t>(position), .value = pack(removed)});
+            }
+            unindex(position);
+            if (position + 1 != modifiers.size()) {
+                modifiers[position] = modifiers.back();
+                keyModifiers.find(modifiers[position].key)->second[modifiers[position].keyPosition] =
+                    static_cast<uint16_t>(position);
+            }
+            modifiers.pop_back();
+            return uint64_t{1} << removed.slot;
+        }
+
+        // La fuente va aparte, en el campo entity de la entrada
+        static uint64_t pack(const Modifier& modifier) {
+            return uint64_t{modifier.key} | uint64_t{modifier.slot} << 32 |
+                   uint64_t{modifier.layer} << 40 | uint64_t{static_cast<uint8_t>(modifier.delta)} << 48;
+        }
+
+        static Modifier unpack(uint64_t value, EntityId source) {
+            return {static_cast<AuraKey>(value), source, static_cast<uint8_t>(value >> 32),
+                    static_cast<uint8_t>(value >> 40), static_cast<int8_t>(static_cast<uint8_t>(value >> 48))};
+        }
+
+        static uint8_t columnIndex(Column column) {
+            return static_cast<uint8_t>(std::find(COLUMNS.begin(), COLUMNS.end(), column) - COLUMNS.begin());
+        }
+
+        void remember(Column column, size_t slot, uint8_t previous) {
+            journal->record({.op = GameJournal::Op::STAT, .small = columnIndex(column),
+                             .index = static_cast<uint32_t>(slot), .value = previous});
+        }
+
+        // Valores previos de los slots seleccionados, antes de aplicar un kernel
+        void remember(Column column, const Selection& selection) {
+            if (!journal) return;
+            for (size_t i = 0; i < CAPACITY; ++i) {
+                if (selection[i]) remember(column, i, (this->*column)[i]);
+            }
+        }
+};
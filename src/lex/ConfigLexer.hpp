@@ -38,7 +38,10 @@ public:
         ATTACK_TARGET,
         ATTACKER,
         SPECIFIC_POSITION,
-        GAME_STATE
+        GAME_STATE,
+        BEAM,       // Primera carta en línea recta
+        CHARGE,     // Celdas libres en línea hasta la primera carta
+        PIERCE      // Todas las cartas en línea recta
     };
     
     // Convertir string de target type a enum
@@ -51,6 +54,9 @@ public:
         if (targetType == "attacker") return TargetType::ATTACKER;
         if (targetType == "specific_position") return TargetType::SPECIFIC_POSITION;
         if (targetType == "game_state") return TargetType::GAME_STATE;
+        if (targetType == "beam") return TargetType::BEAM;
+        if (targetType == "charge") return TargetType::CHARGE;
+        if (targetType == "pierce") return TargetType::PIERCE;
         
         // Valor por defecto
         return TargetType::SELF;
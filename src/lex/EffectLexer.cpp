@@ -72,6 +72,12 @@ namespace lex {
                 goto target_s;
             case 'g':
                 goto target_g;
+            case 'b':
+                goto target_b;
+            case 'c':
+                goto target_c;
+            case 'p':
+                goto target_p;
             default:
                 return std::unexpected(ParseError::UNKNOWN_PREFIX);
         }
@@ -126,6 +132,27 @@ namespace lex {
             return ConfigLexer::TargetType::GAME_STATE;
         }
         return std::unexpected(ParseError::MALFORMED_STRING);
+
+    target_b:
+        ++ptr;
+        if (memcmp(ptr, "eam", 3) == 0 && ptr[3] == '\0') {
+            return ConfigLexer::TargetType::BEAM;
+        }
+        return std::unexpected(ParseError::MALFORMED_STRING);
+
+    target_c:
+        ++ptr;
+        if (memcmp(ptr, "harge", 5) == 0 && ptr[5] == '\0') {
+            return ConfigLexer::TargetType::CHARGE;
+        }
+        return std::unexpected(ParseError::MALFORMED_STRING);
+
+    target_p:
+        ++ptr;
+        if (memcmp(ptr, "ierce", 5) == 0 && ptr[5] == '\0') {
+            return ConfigLexer::TargetType::PIERCE;
+        }
+        return std::unexpected(ParseError::MALFORMED_STRING);
     }
 
     std::expected<GameMap::Adjacency, ParseError> EffectLexer::parseDirectionImpl(const char* input) {
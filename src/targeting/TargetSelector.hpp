@@ -2,8 +2,10 @@
 #include "../game/GameMap.hpp"
 #include "../game/MapCell.hpp"
 #include "../cards/Card.hpp"
+#include "../game/CloneContext.hpp"
 #include <memory>
 #include <string>
+#include "../utils/Symbol.hpp"
 #include <vector>
 #include <list>
 
@@ -16,40 +18,54 @@ class TargetSelector {
 protected:
     CardPtr source;
     PlayerId owner;
-    std::string name;
+    Symbol name;  // Internado: compartido por todas las instancias
+
+    // Implementación de clone() para cada subclase: copia la configuración y el
+    // estado propio y remapea la carta fuente a la partida destino
+    template<typename T>
+    static std::shared_ptr<T> cloneAs(const T& original, CloneContext& context) {
+        auto copy = GameArena::makeShared<T>(original);
+        copy->source = context.card(original.source);
+        return copy;
+    }
 
 public:
-    TargetSelector(CardPtr src, PlayerId ownerId, const std::string& selectorName) 
+    TargetSelector(CardPtr src, PlayerId ownerId, const Symbol& selectorName) 
         : source(src), owner(ownerId), name(selectorName) {}
     
     virtual ~TargetSelector() = default;
     
+    // Copia para GameState::clone, con la fuente remapeada
+    virtual std::shared_ptr<TargetSelector> clone(CloneContext& context) const = 0;
+    
     // Método principal que selecciona los objetivos
-    virtual std::list<MapCell*> selectTargets(GameMap& gameMap, MapCell* triggerCell) = 0;
+    virtual CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) = 0;
     
     // Método para seleccionar objetivos de cartas (para efectos que afectan cartas específicas)
-    virtual std::list<CardPtr> selectCardTargets(GameMap& gameMap, MapCell* triggerCell) {
-        std::list<CardPtr> cards;
+    virtual CardList selectCardTargets(GameMap& gameMap, MapCell* triggerCell) {
+        CardList cards;
         auto cells = selectTargets(gameMap, triggerCell);
         for (auto cell : cells) {
-            if (cell && cell->card.has_value()) {
-                cards.push_back(cell->card.value());
+            if (cell && cell->hasCard()) {
+                cards.push_back(gameMap.getCard(cell));
             }
         }
         return cards;
     }
     
     // Método para verificar si un objetivo es válido
-    virtual bool isValidTarget(MapCell* cell) const {
+    virtual bool isValidTarget(const GameMap& gameMap, MapCell* cell) const {
+        (void)gameMap;
         return cell != nullptr;
     }
     
     // Getter para el nombre del selector
-    const std::string& getName() const { return name; }
+    const std::string& getName() const { return name.str(); }
+    const Symbol& getSymbol() const { return name; }
     
     // Operador para conversión a string (para depuración)
     virtual operator std::string() const {
-        return "TargetSelector: " + name;
+        return "TargetSelector: " + name.str();
     }
 };
 
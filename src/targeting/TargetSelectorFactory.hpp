@@ -1,6 +1,7 @@
 #pragma once
 #include "TargetSelectorImpl.hpp"
 #include "../game/GameMap.hpp"
+#include "../utils/GameArena.hpp"
 #include "../lex/ConfigLexer.hpp"
 #include <memory>
 #include <string>
@@ -9,37 +10,38 @@ class TargetSelectorFactory {
 public:
     // Crear selector para la carta fuente
     static TargetSelectorPtr createSelfSelector(CardPtr source, PlayerId owner) {
-        return std::make_shared<SelfTargetSelector>(source, owner);
+        return GameArena::makeShared<SelfTargetSelector>(source, owner);
     }
     
     // Crear selector para cartas adyacentes
     static TargetSelectorPtr createAdjacentSelector(CardPtr source, PlayerId owner, 
                                                    AdjacentTargetSelector::FilterType filter = AdjacentTargetSelector::FilterType::ALL) {
-        return std::make_shared<AdjacentTargetSelector>(source, owner, filter);
+        return GameArena::makeShared<AdjacentTargetSelector>(source, owner, filter);
     }
     
     // Crear selector para todas las cartas de un tipo
     static TargetSelectorPtr createAllCardsSelector(CardPtr source, PlayerId owner, 
                                                    AllCardsTargetSelector::FilterType filter) {
-        return std::make_shared<AllCardsTargetSelector>(source, owner, filter);
+        return GameArena::makeShared<AllCardsTargetSelector>(source, owner, filter);
     }
     
     // Crear selector para posición específica
     static TargetSelectorPtr createSpecificPositionSelector(CardPtr source, PlayerId owner, 
                                                            uint8_t x, uint8_t y) {
-        return std::make_shared<SpecificPositionTargetSelector>(source, owner, x, y);
+        return GameArena::makeShared<SpecificPositionTargetSelector>(source, owner, x, y);
     }
     
     // Crear selector direccional
     static TargetSelectorPtr createDirectionalSelector(CardPtr source, PlayerId owner, 
                                                       GameMap::Adjacency direction,
-                                                      AdjacentTargetSelector::FilterType filter = AdjacentTargetSelector::FilterType::ALL) {
-        return std::make_shared<DirectionalTargetSelector>(source, owner, direction, filter);
+                                                      AdjacentTargetSelector::FilterType filter = AdjacentTargetSelector::FilterType::ALL,
+                                                      DirectionalTargetSelector::RayMode mode = DirectionalTargetSelector::RayMode::ADJACENT) {
+        return GameArena::makeShared<DirectionalTargetSelector>(source, owner, direction, filter, mode);
     }
     
     // Crear selector para efectos de estado de juego
     static TargetSelectorPtr createGameStateSelector(CardPtr source, PlayerId owner) {
-        return std::make_shared<GameStateTargetSelector>(source, owner);
+        return GameArena::makeShared<GameStateTargetSelector>(source, owner);
     }
     
     // Crear selector desde configuración string
@@ -90,6 +92,12 @@ public:
             return createSpecificPositionSelector(source, owner, x, y);
         } else if (targetType == "directional") {
             return createDirectionalSelector(source, owner, adjDirection, filterType);
+        } else if (targetType == "beam") {
+            return createDirectionalSelector(source, owner, adjDirection, filterType, DirectionalTargetSelector::RayMode::FIRST_BLOCKER);
+        } else if (targetType == "charge") {
+            return createDirectionalSelector(source, owner, adjDirection, filterType, DirectionalTargetSelector::RayMode::UNTIL_BLOCKED);
+        } else if (targetType == "pierce") {
+            return createDirectionalSelector(source, owner, adjDirection, filterType, DirectionalTargetSelector::RayMode::PIERCE);
         } else if (targetType == "game_state") {
             return createGameStateSelector(source, owner);
         }
@@ -103,7 +111,8 @@ public:
                                              ConfigLexer::TargetFilter filter = ConfigLexer::TargetFilter::ANY,
                                              const std::vector<GameMap::Adjacency>& directions = {},
                                              uint8_t x = 0, uint8_t y = 0) {
-        (void)directions; // Suppress unused parameter warning
+        // Las líneas usan la primera dirección configurada (UP por defecto)
+        GameMap::Adjacency lineDirection = directions.empty() ? GameMap::Adjacency::UP : directions.front();
         
         // Convertir filtro de ConfigLexer a AdjacentTargetSelector::FilterType
         AdjacentTargetSelector::FilterType filterType = AdjacentTargetSelector::FilterType::ALL;
@@ -137,6 +146,12 @@ public:
                 return createSpecificPositionSelector(source, owner, x, y);
             case ConfigLexer::TargetType::GAME_STATE:
                 return createGameStateSelector(source, owner);
+            case ConfigLexer::TargetType::BEAM:
+                return createDirectionalSelector(source, owner, lineDirection, filterType, DirectionalTargetSelector::RayMode::FIRST_BLOCKER);
+            case ConfigLexer::TargetType::CHARGE:
+                return createDirectionalSelector(source, owner, lineDirection, filterType, DirectionalTargetSelector::RayMode::UNTIL_BLOCKED);
+            case ConfigLexer::TargetType::PIERCE:
+                return createDirectionalSelector(source, owner, lineDirection, filterType, DirectionalTargetSelector::RayMode::PIERCE);
         }
         
         // Valor por defecto
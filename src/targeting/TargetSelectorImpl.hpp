@@ -6,18 +6,18 @@
 class SelfTargetSelector : public TargetSelector {
 public:
     SelfTargetSelector(CardPtr src, PlayerId ownerId)
-        : TargetSelector(src, ownerId, "Self") {}
+        : TargetSelector(src, ownerId, "Self"_sym) {}
     
-    std::list<MapCell*> selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
+    CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
         (void)triggerCell; // Suprimir warning de parámetro no usado
-        std::list<MapCell*> targets;
+        CellList targets;
         
         // Solo afecta a la carta fuente si está en el mapa
-        if (auto sourceUnit = std::dynamic_pointer_cast<Unit>(source)) {
+        if (const Unit* sourceUnit = Card::as<Unit>(source)) {
             if (sourceUnit->isOnMap()) {
                 auto [x, y] = sourceUnit->getCoordinates();
                 MapCell* sourceCell = gameMap.at(x, y);
-                if (sourceCell && sourceCell->card.has_value()) {
+                if (sourceCell && sourceCell->hasCard()) {
                     targets.push_back(sourceCell);
                 }
             }
@@ -25,6 +25,8 @@ public:
         
         return targets;
     }
+    
+    TargetSelectorPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Selector que afecta cartas adyacentes
@@ -42,45 +44,34 @@ private:
 
 public:
     AdjacentTargetSelector(CardPtr src, PlayerId ownerId, FilterType filterType = FilterType::ALL)
-        : TargetSelector(src, ownerId, "Adjacent"), filter(filterType) {}
+        : TargetSelector(src, ownerId, "Adjacent"_sym), filter(filterType) {}
     
-    std::list<MapCell*> selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
+    CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
         (void)triggerCell; // Suprimir warning de parámetro no usado
-        std::list<MapCell*> targets;
+        CellList targets;
         
         // Obtener posición de la carta fuente
-        if (auto sourceUnit = std::dynamic_pointer_cast<Unit>(source)) {
-            if (sourceUnit->isOnMap()) {
-                auto [x, y] = sourceUnit->getCoordinates();
-                
-                // Calcular celdas adyacentes usando las direcciones
-                std::vector<std::pair<int, int>> adjacentOffsets = {
-                    {-1, -1}, {-1, 0}, {-1, 1},  // arriba-izq, arriba, arriba-der
-                    { 0, -1},          { 0, 1},  // izquierda, derecha
-                    { 1, -1}, { 1, 0}, { 1, 1}   // abajo-izq, abajo, abajo-der
-                };
-                
-                for (auto [dx, dy] : adjacentOffsets) {
-                    int newX = x + dx;
-                    int newY = y + dy;
-                    // Verificar límites del mapa
-                    if (newX >= 0 && newX < GameMap::MAP_WIDTH && newY >= 0 && newY < GameMap::MAP_HEIGHT) {
-                        auto cell = gameMap.at(static_cast<uint8_t>(newX), static_cast<uint8_t>(newY));
-                        if (cell && isValidTarget(cell)) {
-                            targets.push_back(cell);
-                        }
-                    }
-                }
+        const Unit* sourceUnit = Card::as<Unit>(source);
+        if (!sourceUnit || !sourceUnit->isOnMap()) return targets;
+        
+        // Vecinas ocupadas según la adyacencia hexagonal precalculada del mapa
+        // (orientada para el dueño), sin recorrer desplazamientos
+        auto [x, y] = sourceUnit->getCoordinates();
+        const uint64_t neighbors = gameMap.getNeighborMask(gameMap.toIndex(x, y), owner) & gameMap.getOccupiedMask();
+        GameMap::forEachCell(neighbors, [&](CellIndex index) {
+            MapCell* cell = gameMap.at(index);
+            if (isValidTarget(gameMap, cell)) {
+                targets.push_back(cell);
             }
-        }
+        });
         
         return targets;
     }
     
-    bool isValidTarget(MapCell* cell) const override {
-        if (!cell || !cell->card.has_value()) return false;
+    bool isValidTarget(const GameMap& gameMap, MapCell* cell) const override {
+        if (!cell || !cell->hasCard()) return false;
         
-        auto card = cell->card.value();
+        const CardPtr& card = gameMap.getCard(cell);
         
         switch (filter) {
             case FilterType::ALL:
@@ -92,15 +83,17 @@ public:
             case FilterType::ENEMIES_ONLY:
                 // Solo enemigos, sin contar líderes
                 return card->getOwner() != owner && 
-                       std::dynamic_pointer_cast<Legend>(card) == nullptr;
+                       !card->isLegend();
                 
             case FilterType::NON_LEADERS:
                 // Todas las cartas excepto líderes
-                return std::dynamic_pointer_cast<Legend>(card) == nullptr;
+                return !card->isLegend();
         }
         
         return false;
     }
+    
+    TargetSelectorPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Selector que afecta todas las cartas de un tipo en el mapa
@@ -118,29 +111,27 @@ private:
 
 public:
     AllCardsTargetSelector(CardPtr src, PlayerId ownerId, FilterType filterType)
-        : TargetSelector(src, ownerId, "AllCards"), filter(filterType) {}
+        : TargetSelector(src, ownerId, "AllCards"_sym), filter(filterType) {}
     
-    std::list<MapCell*> selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
+    CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
         (void)triggerCell; // Suppress unused parameter warning
-        std::list<MapCell*> targets;
+        CellList targets;
         
         // Recorrer todo el mapa
-        for (uint8_t y = 0; y < gameMap.getHeight(); y++) {
-            for (uint8_t x = 0; x < gameMap.getWidth(); x++) {
-                MapCell* cell = gameMap.at(x, y);
-                if (isValidTarget(cell)) {
-                    targets.push_back(cell);
-                }
+        for (CellIndex index = 0; index < gameMap.getCellCount(); ++index) {
+            MapCell* cell = gameMap.at(index);
+            if (isValidTarget(gameMap, cell)) {
+                targets.push_back(cell);
             }
         }
         
         return targets;
     }
     
-    bool isValidTarget(MapCell* cell) const override {
-        if (!cell || !cell->card.has_value()) return false;
+    bool isValidTarget(const GameMap& gameMap, MapCell* cell) const override {
+        if (!cell || !cell->hasCard()) return false;
         
-        auto card = cell->card.value();
+        const CardPtr& card = gameMap.getCard(cell);
         
         switch (filter) {
             case FilterType::ALL_ALLIES:
@@ -149,12 +140,11 @@ public:
             case FilterType::ALL_ENEMIES:
                 // Solo enemigos, sin contar líderes
                 return card->getOwner() != owner && 
-                       std::dynamic_pointer_cast<Legend>(card) == nullptr;
+                       !card->isLegend();
                 
             case FilterType::ALL_UNITS:
                 // Todas las unidades (sin líderes)
-                return std::dynamic_pointer_cast<Unit>(card) != nullptr &&
-                       std::dynamic_pointer_cast<Legend>(card) == nullptr;
+                return card->isUnit() && !card->isLegend();
                 
             case FilterType::ALL_CARDS:
                 return true;
@@ -162,6 +152,8 @@ public:
         
         return false;
     }
+    
+    TargetSelectorPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Selector que afecta una posición específica
@@ -171,11 +163,11 @@ private:
 
 public:
     SpecificPositionTargetSelector(CardPtr src, PlayerId ownerId, uint8_t x, uint8_t y)
-        : TargetSelector(src, ownerId, "SpecificPosition"), targetX(x), targetY(y) {}
+        : TargetSelector(src, ownerId, "SpecificPosition"_sym), targetX(x), targetY(y) {}
     
-    std::list<MapCell*> selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
+    CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
         (void)triggerCell; // Suppress unused parameter warning
-        std::list<MapCell*> targets;
+        CellList targets;
         
         MapCell* targetCell = gameMap.at(targetX, targetY);
         if (targetCell) {
@@ -184,45 +176,86 @@ public:
         
         return targets;
     }
+    
+    TargetSelectorPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
-// Selector que afecta una dirección específica desde la carta fuente
+// Selector que afecta una dirección específica desde la carta fuente.
+// Las líneas se resuelven con los rayos precalculados del mapa (sin aritmética por paso)
 class DirectionalTargetSelector : public TargetSelector {
+public:
+    enum class RayMode {
+        ADJACENT,       // Solo la celda vecina en esa dirección
+        FIRST_BLOCKER,  // Primera carta en la línea (beam)
+        UNTIL_BLOCKED,  // Celdas libres hasta la primera carta (charge)
+        PIERCE          // Todas las cartas de la línea hasta el borde (pierce)
+    };
+
 private:
     GameMap::Adjacency direction;
     AdjacentTargetSelector::FilterType filter;
+    RayMode mode;
 
 public:
     DirectionalTargetSelector(CardPtr src, PlayerId ownerId, GameMap::Adjacency dir, 
-                            AdjacentTargetSelector::FilterType filterType = AdjacentTargetSelector::FilterType::ALL)
-        : TargetSelector(src, ownerId, "Directional"), direction(dir), filter(filterType) {}
+                            AdjacentTargetSelector::FilterType filterType = AdjacentTargetSelector::FilterType::ALL,
+                            RayMode rayMode = RayMode::ADJACENT)
+        : TargetSelector(src, ownerId, "Directional"_sym), direction(dir), filter(filterType), mode(rayMode) {}
     
-    std::list<MapCell*> selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
+    CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
         (void)triggerCell; // Suppress unused parameter warning
-        std::list<MapCell*> targets;
+        CellList targets;
         
         // Obtener posición de la carta fuente
-        if (auto sourceUnit = std::dynamic_pointer_cast<Unit>(source)) {
-            if (sourceUnit->isOnMap()) {
-                auto [x, y] = sourceUnit->getCoordinates();
-                MapCell* sourceCell = gameMap.at(x, y);
+        const Unit* sourceUnit = Card::as<Unit>(source);
+        if (!sourceUnit || !sourceUnit->isOnMap()) return targets;
+        
+        auto [x, y] = sourceUnit->getCoordinates();
+        auto ray = gameMap.getRay(direction, gameMap.toIndex(x, y), owner);
+        
+        switch (mode) {
+            case RayMode::ADJACENT:
+                if (!ray.empty() && isValidTarget(gameMap, gameMap.at(ray.front()))) {
+                    targets.push_back(gameMap.at(ray.front()));
+                }
+                break;
                 
-                if (sourceCell) {
-                    MapCell* targetCell = gameMap.getNeighbor(direction, sourceCell, owner);
-                    if (isValidTarget(targetCell)) {
-                        targets.push_back(targetCell);
+            case RayMode::FIRST_BLOCKER: {
+                MapCell* blocker = gameMap.at(gameMap.getFirstBlocker(direction, gameMap.toIndex(x, y), owner));
+                if (isValidTarget(gameMap, blocker)) {
+                    targets.push_back(blocker);
+                }
+                break;
+            }
+                
+            case RayMode::UNTIL_BLOCKED: {
+                const uint64_t occupied = gameMap.getOccupiedMask();
+                for (CellIndex index : ray) {
+                    if ((occupied >> index) & 1u) break;
+                    targets.push_back(gameMap.at(index));
+                }
+                break;
+            }
+                
+            case RayMode::PIERCE: {
+                const uint64_t occupied = gameMap.getOccupiedMask();
+                for (CellIndex index : ray) {
+                    MapCell* cell = gameMap.at(index);
+                    if (((occupied >> index) & 1u) && isValidTarget(gameMap, cell)) {
+                        targets.push_back(cell);
                     }
                 }
+                break;
             }
         }
         
         return targets;
     }
     
-    bool isValidTarget(MapCell* cell) const override {
-        if (!cell || !cell->card.has_value()) return false;
+    bool isValidTarget(const GameMap& gameMap, MapCell* cell) const override {
+        if (!cell || !cell->hasCard()) return false;
         
-        auto card = cell->card.value();
+        const CardPtr& card = gameMap.getCard(cell);
         
         switch (filter) {
             case AdjacentTargetSelector::FilterType::ALL:
@@ -234,27 +267,31 @@ public:
             case AdjacentTargetSelector::FilterType::ENEMIES_ONLY:
                 // Solo enemigos, sin contar líderes
                 return card->getOwner() != owner && 
-                       std::dynamic_pointer_cast<Legend>(card) == nullptr;
+                       !card->isLegend();
                 
             case AdjacentTargetSelector::FilterType::NON_LEADERS:
                 // Todas las cartas excepto líderes
-                return std::dynamic_pointer_cast<Legend>(card) == nullptr;
+                return !card->isLegend();
         }
         
         return false;
     }
+    
+    TargetSelectorPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Selector para efectos de estado de juego (no afecta cartas directamente)
 class GameStateTargetSelector : public TargetSelector {
 public:
     GameStateTargetSelector(CardPtr src, PlayerId ownerId)
-        : TargetSelector(src, ownerId, "GameState") {}
+        : TargetSelector(src, ownerId, "GameState"_sym) {}
     
-    std::list<MapCell*> selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
+    CellList selectTargets(GameMap& gameMap, MapCell* triggerCell) override {
         (void)gameMap; // Suppress unused parameter warning
         (void)triggerCell; // Suppress unused parameter warning
         // Los efectos de estado de juego no seleccionan celdas específicas
-        return std::list<MapCell*>();
+        return CellList();
     }
+    
+    TargetSelectorPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
@@ -2,8 +2,10 @@
 #include "../game/GameMap.hpp"
 #include "../game/MapCell.hpp"
 #include "../cards/Card.hpp"
+#include "../game/CloneContext.hpp"
 #include <memory>
 #include <string>
+#include "../utils/Symbol.hpp"
 #include <vector>
 
 // Forward declarations
@@ -14,23 +16,55 @@ class Trigger {
 protected:
     CardPtr source;
     PlayerId owner;
-    std::string name;
+    Symbol name;  // Internado: compartido por todas las instancias
+
+    // Implementación de clone() para cada subclase: copia la configuración y el
+    // estado propio y remapea la carta fuente a la partida destino
+    template<typename T>
+    static std::shared_ptr<T> cloneAs(const T& original, CloneContext& context) {
+        auto copy = GameArena::makeShared<T>(original);
+        copy->source = context.card(original.source);
+        return copy;
+    }
+
+    // Llamar antes de modificar el estado interno en shouldActivate
+    void rememberState(GameMap& gameMap) {
+        if (GameJournal* journal = gameMap.getJournal()) {
+            journal->record({.op = GameJournal::Op::TRIGGER_STATE, .value = getState(), .trigger = this});
+        }
+    }
 
 public:
-    Trigger(CardPtr src, PlayerId ownerId, const std::string& triggerName) 
+    Trigger(CardPtr src, PlayerId ownerId, const Symbol& triggerName) 
         : source(src), owner(ownerId), name(triggerName) {}
     
     virtual ~Trigger() = default;
     
+    // Copia para GameState::clone, con la fuente remapeada
+    virtual std::shared_ptr<Trigger> clone(CloneContext& context) const = 0;
+    
     // Método principal que verifica si el trigger debe activarse
     virtual bool shouldActivate(GameMap& gameMap, MapCell* triggerCell) = 0;
     
+    // Estado interno que shouldActivate puede modificar (triggers por dirección),
+    // empaquetado para el registro de deshacer
+    virtual uint64_t getState() const { return 0; }
+    virtual void setState(uint64_t state) { (void)state; }
+    
+    // Cubo de EffectStack en el que espera este trigger (por defecto, al jugar)
+    virtual TriggerAction getAction() const { return TriggerAction::ON_PLAY; }
+    
+    // Celdas cuyo cambio puede activarlo (máscara de bits), para las
+    // suscripciones por celda de EffectStack; 0 si no depende de una posición
+    virtual uint64_t getWatchedCells(const GameMap& gameMap) const { (void)gameMap; return 0; }
+    
     // Getter para el nombre del trigger
-    const std::string& getName() const { return name; }
+    const std::string& getName() const { return name.str(); }
+    const Symbol& getSymbol() const { return name; }
     
     // Operador para conversión a string (para depuración)
     virtual operator std::string() const {
-        return "Trigger: " + name;
+        return "Trigger: " + name.str();
     }
 };
 
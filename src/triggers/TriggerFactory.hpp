@@ -2,6 +2,7 @@
 #include "Trigger.hpp"
 #include "TriggerImpl.hpp"
 #include "../game/GameMap.hpp"
+#include "../utils/GameArena.hpp"
 #include <memory>
 #include <vector>
 #include <string>
@@ -10,78 +11,78 @@ class TriggerFactory {
 public:
     // Crear trigger de tipo OnPlay
     static TriggerPtr createOnPlayTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnPlayTrigger>(source, owner);
+        return GameArena::makeShared<OnPlayTrigger>(source, owner);
     }
     
     // Crear trigger de tipo OnCast
     static TriggerPtr createOnCastTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnCastTrigger>(source, owner);
+        return GameArena::makeShared<OnCastTrigger>(source, owner);
     }
     
     // Crear trigger de tipo OnStartTurn
     static TriggerPtr createOnStartTurnTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnStartTurnTrigger>(source, owner);
+        return GameArena::makeShared<OnStartTurnTrigger>(source, owner);
     }
     
     // Crear trigger de tipo OnEndTurn
     static TriggerPtr createOnEndTurnTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnEndTurnTrigger>(source, owner);
+        return GameArena::makeShared<OnEndTurnTrigger>(source, owner);
     }
     
     // Crear trigger de tipo OnEnemyEnter (una dirección)
     static TriggerPtr createOnEnemyEnterTrigger(CardPtr source, PlayerId owner, 
                                               GameMap::Adjacency direction) {
-        return std::make_shared<OnEnemyEnterTrigger>(source, owner, direction);
+        return GameArena::makeShared<OnEnemyEnterTrigger>(source, owner, direction);
     }
     
     // Crear trigger de tipo OnEnemyEnter (múltiples direcciones)
     static TriggerPtr createOnEnemyEnterTrigger(CardPtr source, PlayerId owner, 
                                               const std::vector<GameMap::Adjacency>& directions) {
-        return std::make_shared<OnEnemyEnterTrigger>(source, owner, directions);
+        return GameArena::makeShared<OnEnemyEnterTrigger>(source, owner, directions);
     }
     
     // Crear trigger de tipo OnEnemyExit (una dirección)
     static TriggerPtr createOnEnemyExitTrigger(CardPtr source, PlayerId owner, 
                                              GameMap::Adjacency direction) {
-        return std::make_shared<OnEnemyExitTrigger>(source, owner, direction);
+        return GameArena::makeShared<OnEnemyExitTrigger>(source, owner, direction);
     }
     
     // Crear trigger de tipo OnEnemyExit (múltiples direcciones)
     static TriggerPtr createOnEnemyExitTrigger(CardPtr source, PlayerId owner, 
                                              const std::vector<GameMap::Adjacency>& directions) {
-        return std::make_shared<OnEnemyExitTrigger>(source, owner, directions);
+        return GameArena::makeShared<OnEnemyExitTrigger>(source, owner, directions);
     }
     
     // Crear trigger de tipo OnAllyEnter (una dirección)
     static TriggerPtr createOnAllyEnterTrigger(CardPtr source, PlayerId owner, 
                                              GameMap::Adjacency direction) {
-        return std::make_shared<OnAllyEnterTrigger>(source, owner, direction);
+        return GameArena::makeShared<OnAllyEnterTrigger>(source, owner, direction);
     }
     
     // Crear trigger de tipo OnAllyEnter (múltiples direcciones)
     static TriggerPtr createOnAllyEnterTrigger(CardPtr source, PlayerId owner, 
                                              const std::vector<GameMap::Adjacency>& directions) {
-        return std::make_shared<OnAllyEnterTrigger>(source, owner, directions);
+        return GameArena::makeShared<OnAllyEnterTrigger>(source, owner, directions);
     }
     
     // Crear trigger de tipo OnAttack (mapear temporalmente a OnPlay)
     static TriggerPtr createOnAttackTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnPlayTrigger>(source, owner);
+        return GameArena::makeShared<OnPlayTrigger>(source, owner);
     }
     
     // Crear trigger de tipo OnAttacked (mapear temporalmente a OnPlay)
     static TriggerPtr createOnAttackedTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnPlayTrigger>(source, owner);
+        return GameArena::makeShared<OnPlayTrigger>(source, owner);
     }
     
     // Crear trigger de tipo OnKill (mapear temporalmente a OnPlay)
     static TriggerPtr createOnKillTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnPlayTrigger>(source, owner);
+        return GameArena::makeShared<OnPlayTrigger>(source, owner);
     }
     
     // Crear trigger de tipo OnDeath (mapear temporalmente a OnPlay)
     static TriggerPtr createOnDeathTrigger(CardPtr source, PlayerId owner) {
-        return std::make_shared<OnPlayTrigger>(source, owner);
+        return GameArena::makeShared<OnPlayTrigger>(source, owner);
     }
     
     // Método para crear un trigger a partir de un string
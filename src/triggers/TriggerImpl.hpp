@@ -2,11 +2,38 @@
 #include "Trigger.hpp"
 #include <array>
 
+// Estado por dirección de los triggers de entrada/salida como máscara de bits
+inline uint64_t packDirections(const std::array<bool, 6>& directions) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < directions.size(); ++i) bits |= uint64_t{directions[i]} << i;
+    return bits;
+}
+
+inline void unpackDirections(uint64_t bits, std::array<bool, 6>& directions) {
+    for (size_t i = 0; i < directions.size(); ++i) directions[i] = (bits >> i) & 1u;
+}
+
+// Celdas vecinas de la fuente en las direcciones vigiladas (0 si no está en el mapa)
+inline uint64_t watchedNeighborMask(const GameMap& gameMap, const CardPtr& source, PlayerId owner,
+                                    const std::vector<GameMap::Adjacency>& directions) {
+    const Unit* sourceUnit = Card::as<Unit>(source);
+    if (!sourceUnit || !sourceUnit->isOnMap()) return 0;
+    auto [sourceX, sourceY] = sourceUnit->getCoordinates();
+    const CellIndex sourceCell = gameMap.toIndex(sourceX, sourceY);
+    if (sourceCell == NO_CELL) return 0;
+    uint64_t cells = 0;
+    for (const auto& direction : directions) {
+        const CellIndex neighbor = gameMap.getNeighbor(direction, sourceCell, owner);
+        if (neighbor != NO_CELL) cells |= uint64_t{1} << neighbor;
+    }
+    return cells;
+}
+
 // Trigger que se activa inmediatamente al jugar la carta
 class OnPlayTrigger : public Trigger {
 public:
     OnPlayTrigger(CardPtr src, PlayerId ownerId)
-        : Trigger(src, ownerId, "OnPlay") {}
+        : Trigger(src, ownerId, "OnPlay"_sym) {}
     
     bool shouldActivate(GameMap& gameMap, MapCell* triggerCell) override {
         // Este trigger se activa una sola vez al jugar la carta
@@ -14,13 +41,15 @@ public:
         (void)gameMap; (void)triggerCell;
         return true;
     }
+    
+    TriggerPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Trigger que se activa al lanzar un hechizo
 class OnCastTrigger : public Trigger {
 public:
     OnCastTrigger(CardPtr src, PlayerId ownerId)
-        : Trigger(src, ownerId, "OnCast") {}
+        : Trigger(src, ownerId, "OnCast"_sym) {}
     
     bool shouldActivate(GameMap& gameMap, MapCell* triggerCell) override {
         // Este trigger se activa una sola vez al lanzar un hechizo
@@ -28,13 +57,16 @@ public:
         (void)gameMap; (void)triggerCell;
         return true;
     }
+    
+    TriggerAction getAction() const override { return TriggerAction::CAST_EFFECT; }
+    TriggerPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Trigger que se activa al inicio del turno
 class OnStartTurnTrigger : public Trigger {
 public:
     OnStartTurnTrigger(CardPtr src, PlayerId ownerId)
-        : Trigger(src, ownerId, "OnStartTurn") {}
+        : Trigger(src, ownerId, "OnStartTurn"_sym) {}
     
     bool shouldActivate(GameMap& gameMap, MapCell* triggerCell) override {
         // Este trigger se activa al inicio del turno
@@ -42,13 +74,16 @@ public:
         (void)gameMap; (void)triggerCell;
         return true;
     }
+    
+    TriggerAction getAction() const override { return TriggerAction::ON_START_OF_TURN; }
+    TriggerPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Trigger que se activa al final del turno
 class OnEndTurnTrigger : public Trigger {
 public:
     OnEndTurnTrigger(CardPtr src, PlayerId ownerId)
-        : Trigger(src, ownerId, "OnEndTurn") {}
+        : Trigger(src, ownerId, "OnEndTurn"_sym) {}
     
     bool shouldActivate(GameMap& gameMap, MapCell* triggerCell) override {
         // Este trigger se activa al final del turno
@@ -56,6 +91,9 @@ public:
         (void)gameMap; (void)triggerCell;
         return true;
     }
+    
+    TriggerAction getAction() const override { return TriggerAction::ON_END_OF_TURN; }
+    TriggerPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Trigger que se activa cuando una unidad enemiga entra en una dirección específica
@@ -67,14 +105,14 @@ private:
 public:
     // Constructor para una sola dirección
     OnEnemyEnterTrigger(CardPtr src, PlayerId ownerId, GameMap::Adjacency direction)
-        : Trigger(src, ownerId, "OnEnemyEnter") {
+        : Trigger(src, ownerId, "OnEnemyEnter"_sym) {
         watchDirections.push_back(direction);
         appliedEffects.fill(false);
     }
     
     // Constructor para múltiples direcciones
     OnEnemyEnterTrigger(CardPtr src, PlayerId ownerId, const std::vector<GameMap::Adjacency>& directions)
-        : Trigger(src, ownerId, "OnEnemyEnter"), watchDirections(directions) {
+        : Trigger(src, ownerId, "OnEnemyEnter"_sym), watchDirections(directions) {
         appliedEffects.fill(false);
     }
     
@@ -82,16 +120,17 @@ public:
         if (!triggerCell || watchDirections.empty()) return false;
         
         // Verificar que la carta fuente siga en el mapa
-        auto sourceUnit = std::dynamic_pointer_cast<Unit>(source);
+        const Unit* sourceUnit = Card::as<Unit>(source);
         if (!sourceUnit || !sourceUnit->isOnMap()) return false;
         
         auto [sourceX, sourceY] = sourceUnit->getCoordinates();
-        MapCell* sourceCell = gameMap.at(sourceX, sourceY);
-        if (!sourceCell) return false;
+        CellIndex sourceCell = gameMap.toIndex(sourceX, sourceY);
+        if (sourceCell == NO_CELL) return false;
+        rememberState(gameMap);
         
         // Verificar cada dirección monitoreada
         for (const auto& direction : watchDirections) {
-            MapCell* watchedCell = gameMap.getNeighbor(direction, sourceCell, owner);
+            MapCell* watchedCell = gameMap.at(gameMap.getNeighbor(direction, sourceCell, owner));
             if (!watchedCell) continue;
             
             // Índice de la dirección para el array de estado
@@ -100,8 +139,8 @@ public:
             // Verificar si este es el trigger cell
             if (triggerCell == watchedCell) {
                 // Activar si hay una carta enemiga y no se ha aplicado antes
-                if (watchedCell->card.has_value() && 
-                    watchedCell->card.value()->getOwner() != owner && 
+                if (watchedCell->hasCard() && 
+                    gameMap.getCard(watchedCell)->getOwner() != owner && 
                     !appliedEffects[directionIndex]) {
                     
                     appliedEffects[directionIndex] = true;
@@ -110,7 +149,7 @@ public:
             }
             
             // Limpiar estado si la celda está ahora vacía
-            if (!watchedCell->card.has_value()) {
+            if (!watchedCell->hasCard()) {
                 appliedEffects[directionIndex] = false;
             }
         }
@@ -127,6 +166,15 @@ public:
         result += "]";
         return result;
     }
+    
+    uint64_t getState() const override { return packDirections(appliedEffects); }
+    void setState(uint64_t state) override { unpackDirections(state, appliedEffects); }
+    
+    TriggerAction getAction() const override { return TriggerAction::ON_POSITION_ENTER; }
+    uint64_t getWatchedCells(const GameMap& gameMap) const override {
+        return watchedNeighborMask(gameMap, source, owner, watchDirections);
+    }
+    TriggerPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Trigger que se activa cuando una unidad enemiga sale de una dirección específica
@@ -138,14 +186,14 @@ private:
 public:
     // Constructor para una sola dirección
     OnEnemyExitTrigger(CardPtr src, PlayerId ownerId, GameMap::Adjacency direction)
-        : Trigger(src, ownerId, "OnEnemyExit") {
+        : Trigger(src, ownerId, "OnEnemyExit"_sym) {
         watchDirections.push_back(direction);
         hadEnemyBefore.fill(false);
     }
     
     // Constructor para múltiples direcciones
     OnEnemyExitTrigger(CardPtr src, PlayerId ownerId, const std::vector<GameMap::Adjacency>& directions)
-        : Trigger(src, ownerId, "OnEnemyExit"), watchDirections(directions) {
+        : Trigger(src, ownerId, "OnEnemyExit"_sym), watchDirections(directions) {
         hadEnemyBefore.fill(false);
     }
     
@@ -153,23 +201,24 @@ public:
         if (!triggerCell || watchDirections.empty()) return false;
         
         // Verificar que la carta fuente siga en el mapa
-        auto sourceUnit = std::dynamic_pointer_cast<Unit>(source);
+        const Unit* sourceUnit = Card::as<Unit>(source);
         if (!sourceUnit || !sourceUnit->isOnMap()) return false;
         
         auto [sourceX, sourceY] = sourceUnit->getCoordinates();
-        MapCell* sourceCell = gameMap.at(sourceX, sourceY);
-        if (!sourceCell) return false;
+        CellIndex sourceCell = gameMap.toIndex(sourceX, sourceY);
+        if (sourceCell == NO_CELL) return false;
+        rememberState(gameMap);
         
         // Verificar cada dirección monitoreada
         for (const auto& direction : watchDirections) {
-            MapCell* watchedCell = gameMap.getNeighbor(direction, sourceCell, owner);
+            MapCell* watchedCell = gameMap.at(gameMap.getNeighbor(direction, sourceCell, owner));
             if (!watchedCell) continue;
             
             uint8_t directionIndex = static_cast<uint8_t>(direction);
             
             // Si la celda observada está vacía y antes tenía un enemigo
-            if ((!watchedCell->card.has_value() || 
-                 watchedCell->card.value()->getOwner() == owner) && 
+            if ((!watchedCell->hasCard() || 
+                 gameMap.getCard(watchedCell)->getOwner() == owner) && 
                 hadEnemyBefore[directionIndex] && 
                 triggerCell == watchedCell) {
                 
@@ -178,13 +227,22 @@ public:
             }
             
             // Actualizar estado: tiene enemigo ahora
-            if (watchedCell->card.has_value() && watchedCell->card.value()->getOwner() != owner) {
+            if (watchedCell->hasCard() && gameMap.getCard(watchedCell)->getOwner() != owner) {
                 hadEnemyBefore[directionIndex] = true;
             }
         }
         
         return false;
     }
+    
+    uint64_t getState() const override { return packDirections(hadEnemyBefore); }
+    void setState(uint64_t state) override { unpackDirections(state, hadEnemyBefore); }
+    
+    TriggerAction getAction() const override { return TriggerAction::ON_POSITION_EXIT; }
+    uint64_t getWatchedCells(const GameMap& gameMap) const override {
+        return watchedNeighborMask(gameMap, source, owner, watchDirections);
+    }
+    TriggerPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
 
 // Trigger que se activa cuando una unidad aliada entra en una dirección específica
@@ -196,14 +254,14 @@ private:
 public:
     // Constructor para una sola dirección
     OnAllyEnterTrigger(CardPtr src, PlayerId ownerId, GameMap::Adjacency direction)
-        : Trigger(src, ownerId, "OnAllyEnter") {
+        : Trigger(src, ownerId, "OnAllyEnter"_sym) {
         watchDirections.push_back(direction);
         appliedEffects.fill(false);
     }
     
     // Constructor para múltiples direcciones
     OnAllyEnterTrigger(CardPtr src, PlayerId ownerId, const std::vector<GameMap::Adjacency>& directions)
-        : Trigger(src, ownerId, "OnAllyEnter"), watchDirections(directions) {
+        : Trigger(src, ownerId, "OnAllyEnter"_sym), watchDirections(directions) {
         appliedEffects.fill(false);
     }
     
@@ -211,16 +269,17 @@ public:
         if (!triggerCell || watchDirections.empty()) return false;
         
         // Verificar que la carta fuente siga en el mapa
-        auto sourceUnit = std::dynamic_pointer_cast<Unit>(source);
+        const Unit* sourceUnit = Card::as<Unit>(source);
         if (!sourceUnit || !sourceUnit->isOnMap()) return false;
         
         auto [sourceX, sourceY] = sourceUnit->getCoordinates();
-        MapCell* sourceCell = gameMap.at(sourceX, sourceY);
-        if (!sourceCell) return false;
+        CellIndex sourceCell = gameMap.toIndex(sourceX, sourceY);
+        if (sourceCell == NO_CELL) return false;
+        rememberState(gameMap);
         
         // Verificar cada dirección monitoreada
         for (const auto& direction : watchDirections) {
-            MapCell* watchedCell = gameMap.getNeighbor(direction, sourceCell, owner);
+            MapCell* watchedCell = gameMap.at(gameMap.getNeighbor(direction, sourceCell, owner));
             if (!watchedCell) continue;
             
             uint8_t directionIndex = static_cast<uint8_t>(direction);
@@ -228,8 +287,8 @@ public:
             // Verificar si este es el trigger cell
             if (triggerCell == watchedCell) {
                 // Activar si hay una carta aliada y no se ha aplicado antes
-                if (watchedCell->card.has_value() && 
-                    watchedCell->card.value()->getOwner() == owner && 
+                if (watchedCell->hasCard() && 
+                    gameMap.getCard(watchedCell)->getOwner() == owner && 
                     !appliedEffects[directionIndex]) {
                     
                     appliedEffects[directionIndex] = true;
@@ -238,11 +297,20 @@ public:
             }
             
             // Limpiar estado si la celda está ahora vacía
-            if (!watchedCell->card.has_value()) {
+            if (!watchedCell->hasCard()) {
                 appliedEffects[directionIndex] = false;
             }
         }
         
         return false;
     }
+    
+    uint64_t getState() const override { return packDirections(appliedEffects); }
+    void setState(uint64_t state) override { unpackDirections(state, appliedEffects); }
+    
+    TriggerAction getAction() const override { return TriggerAction::ON_POSITION_ENTER; }
+    uint64_t getWatchedCells(const GameMap& gameMap) const override {
+        return watchedNeighborMask(gameMap, source, owner, watchDirections);
+    }
+    TriggerPtr clone(CloneContext& context) const override { return cloneAs(*this, context); }
 };
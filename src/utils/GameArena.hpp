@@ -0,0 +1,89 @@
+#pragma once
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+
+// Arena de memoria de una partida: un monotonic_buffer_resource (bloques
+// grandes que solo se liberan al final) con un pool de listas libres encima,
+// para reutilizar los bloques de objetos destruidos durante la partida.
+// Cartas, efectos, triggers y selectores (objeto y bloque de control del
+// shared_ptr) se crean aquí. Destruir la arena devuelve esos bloques sin
+// ejecutar destructores, así que lo que sus miembros reservan en el heap
+// global (buffers de std::vector o std::string) solo se libera si el objeto
+// se destruye antes: ~GameState rompe los ciclos carta -> efecto -> carta
+// para que todos lo hagan.
+//
+// Los factories no reciben la arena como parámetro: usan la arena activa del
+// hilo (GameArena::Scope), o new/delete si no hay ninguna.
+//
+// Invariante: ningún objeto de una arena sobrevive a ella (soltar después un
+// shared_ptr suyo devuelve memoria a una arena ya liberada). Los objetos de
+// una partida no salen de su GameState: clone() copia en la arena de la copia
+// (CloneContext lo comprueba en compilaciones de depuración) y los datos de
+// proceso, como la caché de CardLoader::loadCatalog, se construyen fuera de
+// cualquier arena (GameArena::Detached).
+class GameArena {
+    private:
+        std::pmr::monotonic_buffer_resource monotonic;
+        std::pmr::unsynchronized_pool_resource pool;
+
+        static inline thread_local std::pmr::memory_resource* active = nullptr;
+
+    public:
+        static constexpr size_t INITIAL_BYTES = 16 * 1024;
+
+        explicit GameArena(size_t initialBytes = INITIAL_BYTES) :
+            monotonic(initialBytes),
+            pool(&monotonic) {}
+
+        GameArena(const GameArena&) = delete;
+        GameArena& operator=(const GameArena&) = delete;
+
+        std::pmr::memory_resource* resource() { return &pool; }
+
+        // Libera todos los bloques. Solo es seguro si ya no queda ningún objeto vivo
+        void reset() {
+            pool.release();
+            monotonic.release();
+        }
+
+        // Activa la arena en el hilo actual mientras dure el scope
+        class Scope {
+            private:
+                std::pmr::memory_resource* previous;
+
+            public:
+                explicit Scope(GameArena& arena) : previous(active) { active = arena.resource(); }
+                ~Scope() { active = previous; }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+        };
+
+        // Desactiva la arena del hilo mientras dure el scope: para datos que
+        // viven más que cualquier partida (cachés de proceso)
+        class Detached {
+            private:
+                std::pmr::memory_resource* previous;
+
+            public:
+                Detached() : previous(active) { active = nullptr; }
+                ~Detached() { active = previous; }
+
+                Detached(const Detached&) = delete;
+                Detached& operator=(const Detached&) = delete;
+        };
+
+        // Esta arena es la activa del hilo
+        bool isCurrent() const { return active == &pool; }
+
+        static std::pmr::memory_resource* current() {
+            return active ? active : std::pmr::new_delete_resource();
+        }
+
+        // make_shared sobre la arena activa: objeto y bloque de control en una sola reserva
+        template<typename T, typename... Args>
+        static std::shared_ptr<T> makeShared(Args&&... args) {
+            return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(current()), std::forward<Args>(args)...);
+        }
+};
@@ -0,0 +1,205 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+
+// Vector con los primeros N elementos guardados dentro del propio objeto.
+// Solo reserva memoria dinámica si se superan los N elementos, así que las
+// listas cortas (efectos de una carta, celdas objetivo) no tocan el heap.
+// Los iteradores son punteros y se invalidan al crecer o borrar, como en std::vector.
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs inline capacity");
+
+    private:
+        T* first;
+        uint32_t count = 0;
+        uint32_t capacity = N;
+        alignas(T) std::byte inlineStorage[N * sizeof(T)];
+
+        T* inlineData() { return std::launder(reinterpret_cast<T*>(inlineStorage)); }
+        bool isInline() const { return first == reinterpret_cast<const T*>(inlineStorage); }
+
+        size_t grownCapacity(size_t minimum) const { return std::max<size_t>(minimum, size_t{capacity} * 2); }
+
+        static T* allocate(size_t elements) {
+            return static_cast<T*>(::operator new(elements * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+
+        // Pasa los elementos al buffer nuevo y suelta el anterior
+        void relocate(T* heap, size_t newCapacity) {
+            std::uninitialized_move(first, first + count, heap);
+            std::destroy(first, first + count);
+            releaseHeap();
+            first = heap;
+            capacity = static_cast<uint32_t>(newCapacity);
+        }
+
+        void grow(size_t minimum) {
+            const size_t newCapacity = grownCapacity(minimum);
+            relocate(allocate(newCapacity), newCapacity);
+        }
+
+        // El elemento nuevo se construye en el buffer nuevo antes de soltar el
+        // anterior: los argumentos pueden ser elementos propios (v.push_back(v[0]))
+        template<typename... Args>
+        T& growAndEmplace(Args&&... args) {
+            const size_t newCapacity = grownCapacity(size_t{count} + 1);
+            T* heap = allocate(newCapacity);
+            T* slot = std::construct_at(heap + count, std::forward<Args>(args)...);
+            relocate(heap, newCapacity);
+            ++count;
+            return *slot;
+        }
+
+        void releaseHeap() {
+            if (!isInline()) ::operator delete(first, std::align_val_t{alignof(T)});
+        }
+
+        // Deja this vacío y en almacenamiento inline, robando el contenido de other
+        void takeFrom(SmallVector&& other) {
+            if (other.isInline()) {
+                std::uninitialized_move(other.first, other.first + other.count, first);
+                count = other.count;
+                other.clear();
+            } else {
+                first = other.first;
+                count = other.count;
+                capacity = other.capacity;
+                other.first = other.inlineData();
+                other.count = 0;
+                other.capacity = N;
+            }
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using size_type = size_t;
+
+        static constexpr size_t INLINE_CAPACITY = N;
+
+        SmallVector() : first(inlineData()) {}
+
+        SmallVector(std::initializer_list<T> values) : SmallVector() {
+            reserve(values.size());
+            for (const T& value : values) push_back(value);
+        }
+
+        SmallVector(const SmallVector& other) : SmallVector() {
+            reserve(other.count);
+            std::uninitialized_copy(other.begin(), other.end(), first);
+            count = other.count;
+        }
+
+        SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVector() {
+            takeFrom(std::move(other));
+        }
+
+        SmallVector& operator=(const SmallVector& other) {
+            if (this != &other) {
+                clear();
+                reserve(other.count);
+                std::uninitialized_copy(other.begin(), other.end(), first);
+                count = other.count;
+            }
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (this != &other) {
+                clear();
+                releaseHeap();
+                first = inlineData();
+                capacity = N;
+                takeFrom(std::move(other));
+            }
+            return *this;
+        }
+
+        ~SmallVector() {
+            clear();
+            releaseHeap();
+        }
+
+        // ===== Acceso =====
+        T* data() { return first; }
+        const T* data() const { return first; }
+        T& operator[](size_t index) { return first[index]; }
+        const T& operator[](size_t index) const { return first[index]; }
+        T& front() { return first[0]; }
+        const T& front() const { return first[0]; }
+        T& back() { return first[count - 1]; }
+        const T& back() const { return first[count - 1]; }
+
+        iterator begin() { return first; }
+        iterator end() { return first + count; }
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return first + count; }
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        bool spilled() const { return !isInline(); }
+
+        // ===== Modificación =====
+        void reserve(size_t minimum) {
+            if (minimum > capacity) grow(minimum);
+        }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args) {
+            if (count == capacity) return growAndEmplace(std::forward<Args>(args)...);
+            T* slot = std::construct_at(first + count, std::forward<Args>(args)...);
+            ++count;
+            return *slot;
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        void pop_back() {
+            std::destroy_at(first + --count);
+        }
+
+        // Inserta antes de position desplazando el resto
+        iterator insert(const_iterator position, T value) {
+            const size_t offset = static_cast<size_t>(position - first);
+            if (count == capacity) grow(size_t{count} + 1);
+            T* slot = first + offset;
+            if (offset == count) {
+                std::construct_at(slot, std::move(value));
+            } else {
+                std::construct_at(end(), std::move(back()));
+                std::move_backward(slot, end() - 1, end());
+                *slot = std::move(value);
+            }
+            ++count;
+            return slot;
+        }
+
+        // Borra conservando el orden del resto
+        iterator erase(const_iterator position) {
+            return erase(position, position + 1);
+        }
+
+        iterator erase(const_iterator from, const_iterator to) {
+            T* target = first + (from - first);
+            T* source = first + (to - first);
+            T* newEnd = std::move(source, end(), target);
+            std::destroy(newEnd, end());
+            count = static_cast<uint32_t>(newEnd - first);
+            return target;
+        }
+
+        void clear() {
+            std::destroy(first, first + count);
+            count = 0;
+        }
+};
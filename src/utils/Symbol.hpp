@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include "../../libs/flat_hash_map.hpp"
+
+// Tabla global de cadenas internadas. Cada texto distinto se guarda una sola
+// vez y nunca se libera, así que las referencias que devuelve son estables.
+// Es segura entre hilos: las búsquedas toman un lock compartido y solo la
+// primera aparición de un texto toma el exclusivo.
+class SymbolTable {
+    private:
+        std::shared_mutex mutex;
+        std::deque<std::string> storage;   // push_back no invalida referencias
+        ska::flat_hash_map<std::string_view, const std::string*> index;
+
+        SymbolTable() { storage.emplace_back(); index.emplace(std::string_view{}, &storage.front()); }
+
+    public:
+        static SymbolTable& instance() {
+            static SymbolTable table;
+            return table;
+        }
+
+        const std::string* intern(std::string_view text) {
+            {
+                std::shared_lock lock(mutex);
+                auto it = index.find(text);
+                if (it != index.end()) return it->second;
+            }
+            std::unique_lock lock(mutex);
+            auto it = index.find(text);
+            if (it != index.end()) return it->second;
+            const std::string* stored = &storage.emplace_back(text);
+            index.emplace(std::string_view(*stored), stored);
+            return stored;
+        }
+
+        const std::string* empty() { return &storage.front(); }
+
+        size_t size() {
+            std::shared_lock lock(mutex);
+            return storage.size();
+        }
+};
+
+// Nombre internado: un puntero a la copia única del texto. Copiar y comparar
+// son operaciones de un puntero
+class Symbol {
+    private:
+        const std::string* text;
+
+    public:
+        Symbol() : text(SymbolTable::instance().empty()) {}
+        explicit Symbol(std::string_view value) : text(SymbolTable::instance().intern(value)) {}
+
+        const std::string& str() const { return *text; }
+        std::string_view view() const { return *text; }
+        operator const std::string&() const { return *text; }
+
+        bool operator==(const Symbol& other) const { return text == other.text; }
+};
+
+// Literal en tiempo de compilación para "texto"_sym: cada literal se interna
+// una sola vez (static local) y después solo cuesta leer el puntero
+template<size_t N>
+struct SymbolLiteral {
+    char value[N];
+    constexpr SymbolLiteral(const char (&literal)[N]) {
+        for (size_t i = 0; i < N; ++i) value[i] = literal[i];
+    }
+};
+
+template<SymbolLiteral Literal>
+const Symbol& operator""_sym() {
+    static const Symbol symbol(std::string_view(Literal.value, sizeof(Literal.value) - 1));
+    return symbol;
+}
@@ -1,9 +1,41 @@
 #pragma once
 #include <cstdint>
 #include <memory>
+#include "SmallVector.hpp"
 
 using PlayerId = uint32_t;
 
+// Handle de celda: índice empaquetado (y * ancho + x) dentro del mapa
+using CellIndex = uint8_t;
+inline constexpr CellIndex NO_CELL = 0xFF;
+
+// Handle de entidad: posición en la EntityTable de la partida (0 = sin carta)
+using EntityId = uint16_t;
+inline constexpr EntityId NO_ENTITY = 0;
+
+// Trigger actions for the effect stack - Mantenemos compatibilidad con sistema legacy
+enum class TriggerAction : uint8_t {
+    ON_PLAY = 0,           // Cuando se juega una carta
+    ON_MOVE = 1,           // Cuando una unidad se mueve
+    ON_ATTACK = 2,         // Cuando una unidad ataca
+    ON_COMBAT = 3,         // Durante el combate
+    ON_DRAW = 4,           // Cuando se roba una carta
+    ON_END_OF_TURN = 5,    // Al final del turno
+    ON_START_OF_TURN= 6,   // Al inicio del turno
+    CAST_EFFECT = 7,       // Al lanzar un hechizo
+    ON_POSITION_ENTER = 8, // Cuando una unidad entra en una posición
+    ON_POSITION_EXIT = 9,  // Cuando una unidad sale de una posición
+    MAX_ACTIONS = 10
+};
+
+// Conjunto de TriggerAction como máscara de bits (un bit por acción)
+using TriggerMask = uint16_t;
+static_assert(static_cast<size_t>(TriggerAction::MAX_ACTIONS) <= 16, "TriggerMask tiene 16 bits");
+
+constexpr TriggerMask triggerBit(TriggerAction action) {
+    return static_cast<TriggerMask>(1u << static_cast<unsigned>(action));
+}
+
 // Forward declarations
 class Card;
 class Unit;
@@ -15,3 +47,8 @@ class MapCell;
 // Define shared pointers
 using CardPtr = std::shared_ptr<Card>;
 using EffectPtr = std::shared_ptr<Effect>;
+
+// Resultados de targeting sin memoria dinámica: caben todas las celdas del
+// mayor mapa soportado (64) y los pocos objetivos de carta de un efecto
+using CellList = SmallVector<MapCell*, 64>;
+using CardList = SmallVector<CardPtr, 8>;
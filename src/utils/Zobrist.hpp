@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+// Claves Zobrist para identificar estados de juego con un hash de 64 bits.
+// En lugar de tablas aleatorias, cada clave se deriva con splitmix64 de
+// (dominio, a, b, c): es determinista entre ejecuciones y no ocupa memoria.
+namespace Zobrist {
+
+    enum class Domain : uint64_t {
+        UNIT = 1,        // Unidad en una celda (id, dueño y estadísticas)
+        HAND,            // Carta en la mano de un jugador (multiconjunto, suma)
+        CURRENT_PLAYER,
+        ACTIONS,         // Acciones restantes de un jugador
+        TURN,
+        PHASE
+    };
+
+    // Finalizador de splitmix64
+    constexpr uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    constexpr uint64_t key(Domain domain, uint64_t a, uint64_t b = 0, uint64_t c = 0) {
+        return mix(mix(mix(mix(static_cast<uint64_t>(domain)) ^ a) ^ b) ^ c);
+    }
+
+} // namespace Zobrist